@@ -10,6 +10,9 @@ let package = Package(
         .library(
             name: "Diffusion",
             targets: ["Diffusion"]),
+        .library(
+            name: "DiffusionExtensions",
+            targets: ["DiffusionExtensions"]),
     ],
     targets: [
         // Targets are the basic building blocks of a package, defining a module or a test suite.
@@ -18,8 +21,15 @@ let package = Package(
             name: "Diffusion",
             path: "./Sources/Diffusion.xcframework"
         ),
+        // Swift-only additions layered over the public API of the binary target.
+        .target(
+            name: "DiffusionExtensions",
+            dependencies: ["Diffusion"]),
         .testTarget(
             name: "DiffusionTests",
             dependencies: ["Diffusion"]),
+        .testTarget(
+            name: "DiffusionExtensionsTests",
+            dependencies: ["DiffusionExtensions"]),
     ]
 )
@@ -0,0 +1,161 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Errors raised when encoding values as CBOR.
+ */
+public enum CBOREncodingError: Error {
+    /// The value, described by the associated string, has no CBOR encoding.
+    case unsupportedValue(String)
+}
+
+/**
+ Encodes Foundation object graphs, as accepted by
+ `-[PTDiffusionJSON initWithObject:error:]`, in two passes: the first computes
+ the exact encoded size and the second writes into a buffer of that size.
+ */
+public enum CBORObjectEncoder {
+    /**
+     Returns the exact number of bytes that `encode(_:into:)` will write for
+     the given object.
+
+     - Throws: `CBOREncodingError.unsupportedValue` if the graph contains an
+       object that cannot be encoded.
+     */
+    public static func encodedSize(of object: Any) throws -> Int {
+        switch try classify(object) {
+        case .data(let data):
+            return CBORWriter.cost(ofBytesWithCount: data.length)
+        case .string(let string):
+            return CBORWriter.cost(ofTextWithUTF8Count: string.utf8.count)
+        case .bool, .null:
+            return CBORWriter.costOfSimpleValue
+        case .integer(let value):
+            return CBORWriter.cost(ofInteger: value)
+        case .unsigned(let value):
+            return CBORWriter.costOfHead(value)
+        case .double:
+            return CBORWriter.costOfDouble
+        case .array(let array):
+            var size = CBORWriter.costOfHead(UInt64(array.count))
+            for element in array {
+                size += try encodedSize(of: element)
+            }
+            return size
+        case .map(let map):
+            var size = CBORWriter.costOfHead(UInt64(map.count))
+            for (key, value) in map {
+                size += try encodedSize(of: key) + encodedSize(of: value)
+            }
+            return size
+        }
+    }
+
+    /**
+     Encodes the object into a caller supplied buffer, such as one reused
+     across values, which must have room for `encodedSize(of:)` bytes.
+
+     - Throws: `CBOREncodingError.unsupportedValue` if the graph contains an
+       object that cannot be encoded.
+     */
+    public static func encode(_ object: Any, into writer: inout CBORWriter) throws {
+        switch try classify(object) {
+        case .data(let data):
+            writer.writeBytes(UnsafeRawBufferPointer(start: data.bytes, count: data.length))
+        case .string(let string):
+            writer.writeText(string)
+        case .bool(let value):
+            writer.writeBool(value)
+        case .null:
+            writer.writeNull()
+        case .integer(let value):
+            writer.writeInteger(value)
+        case .unsigned(let value):
+            writer.writeUnsigned(value)
+        case .double(let value):
+            writer.writeDouble(value)
+        case .array(let array):
+            writer.writeArrayHeader(count: array.count)
+            for element in array {
+                try encode(element, into: &writer)
+            }
+        case .map(let map):
+            writer.writeMapHeader(count: map.count)
+            for (key, value) in map {
+                try encode(key, into: &writer)
+                try encode(value, into: &writer)
+            }
+        }
+    }
+
+    /**
+     Encodes the object into newly allocated data of exactly the encoded size.
+     */
+    public static func data(for object: Any) throws -> Data {
+        return try CBORWriter.data(count: encodedSize(of: object)) { writer in
+            try encode(object, into: &writer)
+        }
+    }
+
+    private enum Kind {
+        case data(NSData)
+        case string(String)
+        case bool(Bool)
+        case null
+        case integer(Int64)
+        case unsigned(UInt64)
+        case double(Double)
+        case array(NSArray)
+        case map(NSDictionary)
+    }
+
+    private static func classify(_ object: Any) throws -> Kind {
+        switch object {
+        case let data as NSData:
+            return .data(data)
+        case let string as String:
+            return .string(string)
+        case let number as NSNumber:
+            if CFGetTypeID(number) == CFBooleanGetTypeID() {
+                return .bool(number.boolValue)
+            }
+            if CFNumberIsFloatType(number as CFNumber) {
+                return .double(number.doubleValue)
+            }
+            // Only unsigned 64 bit values can exceed the range of Int64.
+            if number.objCType.pointee == CChar(UInt8(ascii: "Q")) && number.int64Value < 0 {
+                return .unsigned(number.uint64Value)
+            }
+            return .integer(number.int64Value)
+        case is NSNull:
+            return .null
+        case let array as NSArray:
+            return .array(array)
+        case let map as NSDictionary:
+            return .map(map)
+        default:
+            throw CBOREncodingError.unsupportedValue(String(describing: type(of: object)))
+        }
+    }
+}
+
+extension PTDiffusionJSON {
+    /**
+     Returns a JSON object initialized with the given object, encoded into a
+     buffer of exactly the required size rather than one that grows as it is
+     written.
+
+     The object must satisfy the same constraints as for
+     `-[PTDiffusionJSON initWithObject:error:]`.
+     */
+    public convenience init(exactlySizedObject object: Any) throws {
+        let data = try CBORObjectEncoder.data(for: object)
+        self.init(data: data)
+    }
+}
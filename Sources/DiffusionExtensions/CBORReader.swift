@@ -0,0 +1,441 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Errors raised when CBOR input is not well formed.
+ */
+public enum CBORError: Error, Equatable {
+    /// The input ended part way through a data item.
+    case unexpectedEnd(offset: Int)
+
+    /// The initial byte at the offset uses reserved or invalid additional
+    /// information for its major type.
+    case malformed(offset: Int)
+
+    /// A break marker appeared outside of an indefinite length item.
+    case unexpectedBreak(offset: Int)
+
+    /// Items were nested more deeply than `CBORReader.maximumDepth`.
+    case nestingTooDeep(offset: Int)
+
+    /// A text string contains a byte, at the offset, that does not begin a
+    /// valid UTF-8 sequence.
+    case invalidUTF8(offset: Int)
+}
+
+/**
+ A single CBOR token as yielded by `CBORReader`.
+
+ String tokens hold the range of their content within the reader's buffer
+ rather than a copy of it. Use `CBORReader.slice(_:)` to access the bytes.
+ */
+public enum CBORToken: Equatable {
+    /// Major type 0.
+    case unsigned(UInt64)
+
+    /// Major type 1, holding the encoded argument `n` of the value `-1 - n`.
+    case negative(UInt64)
+
+    /// Major type 2 with a definite length.
+    case bytes(Range<Int>)
+
+    /// Major type 3 with a definite length.
+    case text(Range<Int>)
+
+    /// Start of an indefinite length byte string. Definite length byte string
+    /// chunks follow, terminated by `.break`.
+    case indefiniteBytes
+
+    /// Start of an indefinite length text string. Definite length text string
+    /// chunks follow, terminated by `.break`.
+    case indefiniteText
+
+    /// Start of an array of `count` items, or indefinite length if `nil`.
+    case array(count: Int?)
+
+    /// Start of a map of `count` key/value pairs, or indefinite length if `nil`.
+    case map(count: Int?)
+
+    /// A tag applying to the item which follows.
+    case tag(UInt64)
+
+    /// An unassigned simple value.
+    case simple(UInt8)
+
+    case bool(Bool)
+
+    case null
+
+    case undefined
+
+    /// A half, single or double precision floating point value.
+    case float(Double)
+
+    /// Terminates an indefinite length item.
+    case `break`
+}
+
+/**
+ A forward-only, pull-style reader over CBOR encoded bytes.
+
+ The reader never allocates: it yields tokens one at a time and refers to
+ string content by range within the buffer it was created over. This makes it
+ suitable for extracting a few fields from a large `PTDiffusionJSON` value
+ without building the Foundation object graph returned by
+ `-[PTDiffusionJSON objectWithError:]`.
+
+ The buffer must remain valid for as long as the reader is used, so readers
+ are normally obtained through `PTDiffusionBytes.withCBORReader(_:)`.
+
+ If a method throws, the reader's offset is left where it was before the call.
+ */
+public struct CBORReader {
+    /// The deepest nesting of arrays, maps and tags that `skipItem()` accepts.
+    public static let maximumDepth = 512
+
+    /// The bytes being read.
+    public let buffer: UnsafeRawBufferPointer
+
+    /// Offset within `buffer` of the next token.
+    public private(set) var offset: Int
+
+    /**
+     Creates a reader over the buffer.
+
+     - Parameter offset: The offset of the first token to read, which must
+       be the start of a data item.
+     */
+    public init(_ buffer: UnsafeRawBufferPointer, offset: Int = 0) {
+        precondition(offset >= 0 && offset <= buffer.count)
+        self.buffer = buffer
+        self.offset = offset
+    }
+
+    /// `true` if there are no more bytes to read.
+    public var isAtEnd: Bool {
+        return offset >= buffer.count
+    }
+
+    /// `true` if the next byte is a break marker.
+    public var isAtBreak: Bool {
+        return offset < buffer.count && buffer[offset] == 0xff
+    }
+
+    /**
+     Reads the next token.
+
+     - Returns: The token, with the reader positioned after it. For definite
+       length strings this is after the string content; for arrays, maps and
+       tags it is at the first nested item.
+
+     - Throws: `CBORError` if the input is not well formed.
+     */
+    public mutating func next() throws -> CBORToken {
+        let start = offset
+        guard start < buffer.count else {
+            throw CBORError.unexpectedEnd(offset: start)
+        }
+        var cursor = start + 1
+        let initial = buffer[start]
+        let major = initial >> 5
+        let info = initial & 0x1f
+
+        if major == 7 {
+            let token = try readSimpleOrFloat(info: info, start: start, cursor: &cursor)
+            offset = cursor
+            return token
+        }
+
+        if info == 31 {
+            let token: CBORToken
+            switch major {
+            case 2: token = .indefiniteBytes
+            case 3: token = .indefiniteText
+            case 4: token = .array(count: nil)
+            case 5: token = .map(count: nil)
+            default: throw CBORError.malformed(offset: start)
+            }
+            offset = cursor
+            return token
+        }
+
+        let argument = try readArgument(info: info, start: start, cursor: &cursor)
+        let remaining = UInt64(buffer.count - cursor)
+        let token: CBORToken
+        switch major {
+        case 0:
+            token = .unsigned(argument)
+        case 1:
+            token = .negative(argument)
+        case 2, 3:
+            guard argument <= remaining else {
+                throw CBORError.unexpectedEnd(offset: start)
+            }
+            let range = cursor ..< cursor + Int(argument)
+            cursor = range.upperBound
+            token = major == 2 ? .bytes(range) : .text(range)
+        case 4:
+            // Every item occupies at least one byte.
+            guard argument <= remaining else {
+                throw CBORError.unexpectedEnd(offset: start)
+            }
+            token = .array(count: Int(argument))
+        case 5:
+            guard argument <= remaining / 2 else {
+                throw CBORError.unexpectedEnd(offset: start)
+            }
+            token = .map(count: Int(argument))
+        default:
+            token = .tag(argument)
+        }
+        offset = cursor
+        return token
+    }
+
+    /**
+     Consumes a break marker if one is next.
+
+     - Returns: `true` if a break marker was consumed.
+     */
+    public mutating func consumeBreak() -> Bool {
+        guard isAtBreak else {
+            return false
+        }
+        offset += 1
+        return true
+    }
+
+    /**
+     Returns whether an array or map has another item, consuming the break
+     marker that ends one of indefinite length.
+
+     - Parameter count: The count from the `.array` or `.map` token, or
+       `nil` for indefinite length.
+     - Parameter index: The number of items already read. For maps, count
+       key/value pairs.
+     */
+    public mutating func hasItem(count: Int?, index: Int) -> Bool {
+        if let count = count {
+            return index < count
+        }
+        return !consumeBreak()
+    }
+
+    /**
+     Skips the next complete data item, including any nested items and any
+     tags applied to it, without decoding it.
+
+     - Throws: `CBORError` if the input is not well formed.
+     */
+    public mutating func skipItem() throws {
+        let start = offset
+        do {
+            try skipItem(depth: 0)
+        } catch {
+            offset = start
+            throw error
+        }
+    }
+
+    /**
+     Returns the bytes within the given range of the buffer, typically the
+     range of a `.bytes` or `.text` token. No bytes are copied.
+     */
+    public func slice(_ range: Range<Int>) -> UnsafeRawBufferPointer {
+        return UnsafeRawBufferPointer(rebasing: buffer[range])
+    }
+
+    /**
+     Compares the UTF-8 content of a text range with a string, without
+     allocating.
+     */
+    public func text(_ range: Range<Int>, equals string: String) -> Bool {
+        return slice(range).elementsEqual(string.utf8)
+    }
+
+    /**
+     Materialises a text range as a string. Unlike the other accessors this
+     allocates. Invalid UTF-8 sequences are replaced with U+FFFD.
+     */
+    public func string(_ range: Range<Int>) -> String {
+        return String(decoding: slice(range), as: UTF8.self)
+    }
+
+    /**
+     Materialises a text range as a string, rejecting invalid UTF-8.
+
+     Swift has no public way to build a string from bytes without validating
+     them, so the content is validated once, by the standard library, as the
+     string is built. `UTF8Validation` is used only to locate the invalid
+     bytes when it is rejected.
+
+     - Parameter table: If given, strings are looked up in and added to the
+       table so that repeated content, such as map keys, is shared.
+
+     - Throws: `CBORError.invalidUTF8` if the content is not valid UTF-8.
+     */
+    public func validatedString(_ range: Range<Int>,
+                                interning table: CBORStringTable? = nil) throws -> String {
+        let bytes = slice(range)
+        let string: String?
+        if let table = table {
+            string = table.string(for: bytes)
+        } else {
+            string = CBORStringTable.makeString(bytes)
+        }
+        guard let result = string else {
+            let invalid = UTF8Validation.firstInvalidOffset(in: bytes) ?? 0
+            throw CBORError.invalidUTF8(offset: range.lowerBound + invalid)
+        }
+        return result
+    }
+
+    private mutating func skipItem(depth: Int) throws {
+        guard depth < CBORReader.maximumDepth else {
+            throw CBORError.nestingTooDeep(offset: offset)
+        }
+        let start = offset
+        switch try next() {
+        case .array(let count?):
+            for _ in 0 ..< count {
+                try skipItem(depth: depth + 1)
+            }
+        case .map(let count?):
+            for _ in 0 ..< count * 2 {
+                try skipItem(depth: depth + 1)
+            }
+        case .array(nil):
+            while !consumeBreak() {
+                try skipItem(depth: depth + 1)
+            }
+        case .map(nil):
+            var items = 0
+            while !consumeBreak() {
+                try skipItem(depth: depth + 1)
+                items += 1
+            }
+            guard items % 2 == 0 else {
+                throw CBORError.malformed(offset: start)
+            }
+        case .indefiniteBytes:
+            try skipChunks(major: 2)
+        case .indefiniteText:
+            try skipChunks(major: 3)
+        case .tag:
+            try skipItem(depth: depth + 1)
+        case .break:
+            throw CBORError.unexpectedBreak(offset: start)
+        default:
+            break
+        }
+    }
+
+    private mutating func skipChunks(major: UInt8) throws {
+        while !consumeBreak() {
+            let chunk = offset
+            guard chunk < buffer.count else {
+                throw CBORError.unexpectedEnd(offset: chunk)
+            }
+            // Chunks must be definite length strings of the same major type.
+            guard buffer[chunk] >> 5 == major, buffer[chunk] & 0x1f != 31 else {
+                throw CBORError.malformed(offset: chunk)
+            }
+            _ = try next()
+        }
+    }
+
+    private func readArgument(info: UInt8,
+                              start: Int,
+                              cursor: inout Int) throws -> UInt64 {
+        let width: Int
+        switch info {
+        case 0 ..< 24: return UInt64(info)
+        case 24: width = 1
+        case 25: width = 2
+        case 26: width = 4
+        case 27: width = 8
+        default: throw CBORError.malformed(offset: start)
+        }
+        guard buffer.count - cursor >= width else {
+            throw CBORError.unexpectedEnd(offset: start)
+        }
+        let value: UInt64
+        switch width {
+        case 1:
+            value = UInt64(buffer[cursor])
+        case 2:
+            value = UInt64(UInt16(bigEndian: buffer.unalignedLoad(fromByteOffset: cursor, as: UInt16.self)))
+        case 4:
+            value = UInt64(UInt32(bigEndian: buffer.unalignedLoad(fromByteOffset: cursor, as: UInt32.self)))
+        default:
+            value = UInt64(bigEndian: buffer.unalignedLoad(fromByteOffset: cursor, as: UInt64.self))
+        }
+        cursor += width
+        return value
+    }
+
+    private func readSimpleOrFloat(info: UInt8,
+                                   start: Int,
+                                   cursor: inout Int) throws -> CBORToken {
+        switch info {
+        case 20: return .bool(false)
+        case 21: return .bool(true)
+        case 22: return .null
+        case 23: return .undefined
+        case 31: return .break
+        case 0 ..< 20: return .simple(info)
+        case 28 ..< 31: throw CBORError.malformed(offset: start)
+        default: break
+        }
+        let argument = try readArgument(info: info, start: start, cursor: &cursor)
+        switch info {
+        case 24:
+            // Values below 32 must use the one byte encoding.
+            guard argument >= 32 else {
+                throw CBORError.malformed(offset: start)
+            }
+            return .simple(UInt8(argument))
+        case 25:
+            return .float(CBORReader.double(fromHalf: UInt16(argument)))
+        case 26:
+            return .float(Double(Float(bitPattern: UInt32(argument))))
+        default:
+            return .float(Double(bitPattern: argument))
+        }
+    }
+
+    static func double(fromHalf bits: UInt16) -> Double {
+        let exponent = Int(bits >> 10) & 0x1f
+        let mantissa = Double(bits & 0x3ff)
+        let magnitude: Double
+        switch exponent {
+        case 0:
+            magnitude = Double(sign: .plus, exponent: -24, significand: mantissa)
+        case 31:
+            magnitude = mantissa == 0 ? .infinity : .nan
+        default:
+            magnitude = Double(sign: .plus, exponent: exponent - 25, significand: mantissa + 1024)
+        }
+        return bits & 0x8000 != 0 ? -magnitude : magnitude
+    }
+}
+
+extension PTDiffusionBytes {
+    /**
+     Calls the given closure with a reader over the receiver's data.
+
+     The reader and any slices obtained from it must not escape the closure.
+     */
+    public func withCBORReader<Result>(_ body: (inout CBORReader) throws -> Result) rethrows -> Result {
+        return try data.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            return try body(&reader)
+        }
+    }
+}
@@ -0,0 +1,117 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+
+/**
+ Interns text strings read from CBOR so that repeated content, such as the
+ keys of maps in successive values of the same topic, decodes to a shared
+ string instead of a new one each time.
+
+ Lookups hash and compare the encoded bytes directly, so a hit neither
+ validates nor allocates. Only strings of up to `maximumLength` bytes are
+ interned and the table stops growing once it holds `capacity` strings.
+
+ A table is not thread safe. Use one per decoding thread or value stream.
+ */
+public final class CBORStringTable {
+    private struct Entry {
+        let hash: UInt64
+        let string: String
+    }
+
+    /// The most strings the table will hold.
+    public let capacity: Int
+
+    /// The longest string, in UTF-8 bytes, that the table will intern.
+    public let maximumLength: Int
+
+    /// The number of strings currently interned.
+    public private(set) var count = 0
+
+    private var slots: [Entry?]
+    private let mask: Int
+
+    public init(capacity: Int = 1024, maximumLength: Int = 64) {
+        precondition(capacity > 0 && maximumLength >= 0)
+        self.capacity = capacity
+        self.maximumLength = maximumLength
+        // Keep the load factor at or below one half.
+        var size = 2
+        while size < capacity * 2 {
+            size <<= 1
+        }
+        self.slots = [Entry?](repeating: nil, count: size)
+        self.mask = size - 1
+    }
+
+    /**
+     Returns the string for the given UTF-8 bytes, interning it if there is
+     room.
+
+     - Returns: The string, or `nil` if the bytes are not valid UTF-8.
+     */
+    public func string(for bytes: UnsafeRawBufferPointer) -> String? {
+        guard bytes.count <= maximumLength else {
+            return CBORStringTable.makeString(bytes)
+        }
+        let hash = CBORStringTable.hash(bytes)
+        var slot = Int(truncatingIfNeeded: hash) & mask
+        while let entry = slots[slot] {
+            if entry.hash == hash && CBORStringTable.string(entry.string, equals: bytes) {
+                return entry.string
+            }
+            slot = (slot + 1) & mask
+        }
+        guard let string = CBORStringTable.makeString(bytes) else {
+            return nil
+        }
+        if count < capacity {
+            slots[slot] = Entry(hash: hash, string: string)
+            count += 1
+        }
+        return string
+    }
+
+    /// Discards all interned strings.
+    public func removeAll() {
+        for index in slots.indices {
+            slots[index] = nil
+        }
+        count = 0
+    }
+
+    /// Returns the string for the given bytes, or `nil` if they are not valid
+    /// UTF-8. The standard library validates the bytes as it decodes them,
+    /// replacing invalid sequences with U+FFFD, so the decoded string holds
+    /// the same bytes only if they were valid.
+    static func makeString(_ bytes: UnsafeRawBufferPointer) -> String? {
+        let string = String(decoding: bytes, as: UTF8.self)
+        return CBORStringTable.string(string, equals: bytes) ? string : nil
+    }
+
+    // FNV-1a, which is cheap for the short strings that are interned.
+    private static func hash(_ bytes: UnsafeRawBufferPointer) -> UInt64 {
+        var hash: UInt64 = 0xcbf29ce484222325
+        for byte in bytes {
+            hash = (hash ^ UInt64(byte)) &* 0x100000001b3
+        }
+        return hash
+    }
+
+    private static func string(_ string: String, equals bytes: UnsafeRawBufferPointer) -> Bool {
+        let utf8 = string.utf8
+        guard utf8.count == bytes.count else {
+            return false
+        }
+        if let equal = utf8.withContiguousStorageIfAvailable({ storage in
+            storage.isEmpty || memcmp(storage.baseAddress!, bytes.baseAddress!, storage.count) == 0
+        }) {
+            return equal
+        }
+        return utf8.elementsEqual(bytes)
+    }
+}
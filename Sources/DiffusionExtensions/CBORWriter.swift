@@ -0,0 +1,191 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+
+/**
+ Writes CBOR into a caller supplied buffer that never grows.
+
+ Each write has a matching cost function returning the exact number of bytes
+ it produces, so encoders can size the buffer in a first pass and then write
+ into it in a second pass with no reallocation. Writing beyond the end of the
+ buffer is a programming error and traps.
+ */
+public struct CBORWriter {
+    /// The buffer being written.
+    public let buffer: UnsafeMutableRawBufferPointer
+
+    /// The number of bytes written so far.
+    public private(set) var offset: Int
+
+    public init(_ buffer: UnsafeMutableRawBufferPointer) {
+        self.buffer = buffer
+        self.offset = 0
+    }
+
+    // MARK: Costs
+
+    /// The encoded size of an initial byte with the given argument.
+    public static func costOfHead(_ argument: UInt64) -> Int {
+        switch argument {
+        case 0 ..< 24: return 1
+        case 24 ... 0xff: return 2
+        case 0x100 ... 0xffff: return 3
+        case 0x1_0000 ... 0xffff_ffff: return 5
+        default: return 9
+        }
+    }
+
+    public static func cost(ofInteger value: Int64) -> Int {
+        return costOfHead(value < 0 ? UInt64(bitPattern: ~value) : UInt64(value))
+    }
+
+    public static func cost(ofTextWithUTF8Count count: Int) -> Int {
+        return costOfHead(UInt64(count)) + count
+    }
+
+    public static func cost(ofBytesWithCount count: Int) -> Int {
+        return costOfHead(UInt64(count)) + count
+    }
+
+    /// The encoded size of a double precision float.
+    public static let costOfDouble = 9
+
+    /// The encoded size of a bool or null.
+    public static let costOfSimpleValue = 1
+
+    // MARK: Writing
+
+    public mutating func writeUnsigned(_ value: UInt64) {
+        writeHead(major: 0, argument: value)
+    }
+
+    /// Writes major type 1 with the argument `n`, representing `-1 - n`.
+    public mutating func writeNegative(_ argument: UInt64) {
+        writeHead(major: 1, argument: argument)
+    }
+
+    public mutating func writeInteger(_ value: Int64) {
+        if value < 0 {
+            writeNegative(UInt64(bitPattern: ~value))
+        } else {
+            writeUnsigned(UInt64(value))
+        }
+    }
+
+    public mutating func writeBytes(_ bytes: UnsafeRawBufferPointer) {
+        writeHead(major: 2, argument: UInt64(bytes.count))
+        writeRaw(bytes)
+    }
+
+    /// Writes already validated UTF-8 as a text string.
+    public mutating func writeText(utf8 bytes: UnsafeRawBufferPointer) {
+        writeHead(major: 3, argument: UInt64(bytes.count))
+        writeRaw(bytes)
+    }
+
+    public mutating func writeText(_ string: String) {
+        let utf8 = string.utf8
+        writeHead(major: 3, argument: UInt64(utf8.count))
+        let written = utf8.withContiguousStorageIfAvailable { storage -> Bool in
+            writeRaw(UnsafeRawBufferPointer(storage))
+            return true
+        }
+        if written == nil {
+            for byte in utf8 {
+                writeByte(byte)
+            }
+        }
+    }
+
+    public mutating func writeArrayHeader(count: Int) {
+        writeHead(major: 4, argument: UInt64(count))
+    }
+
+    public mutating func writeMapHeader(count: Int) {
+        writeHead(major: 5, argument: UInt64(count))
+    }
+
+    public mutating func writeBool(_ value: Bool) {
+        writeByte(value ? 0xf5 : 0xf4)
+    }
+
+    public mutating func writeNull() {
+        writeByte(0xf6)
+    }
+
+    public mutating func writeDouble(_ value: Double) {
+        writeByte(0xfb)
+        writeBigEndian(value.bitPattern)
+    }
+
+    /// Writes an initial byte and its argument in the shortest form.
+    public mutating func writeHead(major: UInt8, argument: UInt64) {
+        let type = major << 5
+        switch argument {
+        case 0 ..< 24:
+            writeByte(type | UInt8(argument))
+        case 24 ... 0xff:
+            writeByte(type | 24)
+            writeByte(UInt8(argument))
+        case 0x100 ... 0xffff:
+            writeByte(type | 25)
+            writeBigEndian(UInt16(argument))
+        case 0x1_0000 ... 0xffff_ffff:
+            writeByte(type | 26)
+            writeBigEndian(UInt32(argument))
+        default:
+            writeByte(type | 27)
+            writeBigEndian(argument)
+        }
+    }
+
+    public mutating func writeRaw(_ bytes: UnsafeRawBufferPointer) {
+        precondition(buffer.count - offset >= bytes.count, "CBOR buffer overflow")
+        if let source = bytes.baseAddress, bytes.count > 0 {
+            (buffer.baseAddress! + offset).copyMemory(from: source, byteCount: bytes.count)
+        }
+        offset += bytes.count
+    }
+
+    mutating func writeByte(_ byte: UInt8) {
+        precondition(offset < buffer.count, "CBOR buffer overflow")
+        buffer[offset] = byte
+        offset += 1
+    }
+
+    private mutating func writeBigEndian<T: FixedWidthInteger>(_ value: T) {
+        precondition(buffer.count - offset >= MemoryLayout<T>.size, "CBOR buffer overflow")
+        buffer.storeBytes(of: value.bigEndian, toByteOffset: offset, as: T.self)
+        offset += MemoryLayout<T>.size
+    }
+}
+
+extension CBORWriter {
+    /**
+     Allocates a buffer of exactly `count` bytes, calls `body` to fill it and
+     returns the result as data that takes ownership of the buffer, so the
+     encoded bytes are neither reallocated nor copied.
+     */
+    public static func data(count: Int,
+                            _ body: (inout CBORWriter) throws -> Void) rethrows -> Data {
+        guard count > 0 else {
+            return Data()
+        }
+        let storage = UnsafeMutableRawPointer.allocate(byteCount: count, alignment: 1)
+        var writer = CBORWriter(UnsafeMutableRawBufferPointer(start: storage, count: count))
+        do {
+            try body(&writer)
+        } catch {
+            storage.deallocate()
+            throw error
+        }
+        precondition(writer.offset == count, "CBOR cost does not match bytes written")
+        return Data(bytesNoCopy: storage, count: count, deallocator: .custom { pointer, _ in
+            pointer.deallocate()
+        })
+    }
+}
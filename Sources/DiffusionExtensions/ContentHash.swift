@@ -0,0 +1,184 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import ObjectiveC
+import Diffusion
+
+/**
+ The 64-bit xxHash (XXH64) of a buffer, with a seed of zero.
+
+ The main loop hashes 32-byte stripes as the four independent 64-bit lanes
+ of a `SIMD4` vector. Neither NEON nor SSE has a 64-bit lane multiply, so the
+ multiplies are issued per lane, but the lanes have no dependencies on each
+ other and run in parallel.
+ */
+enum ContentHash {
+    private static let prime1: UInt64 = 0x9E3779B185EBCA87
+    private static let prime2: UInt64 = 0xC2B2AE3D27D4EB4F
+    private static let prime3: UInt64 = 0x165667B19E3779F9
+    private static let prime4: UInt64 = 0x85EBCA77C2B2AE63
+    private static let prime5: UInt64 = 0x27D4EB2F165667C5
+
+    static func hash(_ buffer: UnsafeRawBufferPointer) -> UInt64 {
+        let count = buffer.count
+        var index = 0
+        var hash: UInt64
+        if count >= 32 {
+            var lanes = SIMD4<UInt64>(prime1 &+ prime2, prime2, 0, 0 &- prime1)
+            let p1 = SIMD4<UInt64>(repeating: prime1)
+            let p2 = SIMD4<UInt64>(repeating: prime2)
+            while index + 32 <= count {
+                // All supported platforms are little endian, as XXH64 requires.
+                let stripe = buffer.unalignedLoad(fromByteOffset: index, as: SIMD4<UInt64>.self)
+                lanes &+= stripe &* p2
+                lanes = (lanes &<< 31) | (lanes &>> 33)
+                lanes &*= p1
+                index += 32
+            }
+            hash = rotate(lanes[0], 1) &+ rotate(lanes[1], 7) &+ rotate(lanes[2], 12) &+ rotate(lanes[3], 18)
+            for lane in 0 ..< 4 {
+                hash ^= round(0, lanes[lane])
+                hash = hash &* prime1 &+ prime4
+            }
+        } else {
+            hash = prime5
+        }
+        hash &+= UInt64(count)
+        while index + 8 <= count {
+            let word = UInt64(littleEndian: buffer.unalignedLoad(fromByteOffset: index, as: UInt64.self))
+            hash ^= round(0, word)
+            hash = rotate(hash, 27) &* prime1 &+ prime4
+            index += 8
+        }
+        if index + 4 <= count {
+            let word = UInt32(littleEndian: buffer.unalignedLoad(fromByteOffset: index, as: UInt32.self))
+            hash ^= UInt64(word) &* prime1
+            hash = rotate(hash, 23) &* prime2 &+ prime3
+            index += 4
+        }
+        while index < count {
+            hash ^= UInt64(buffer[index]) &* prime5
+            hash = rotate(hash, 11) &* prime1
+            index += 1
+        }
+        hash ^= hash >> 33
+        hash &*= prime2
+        hash ^= hash >> 29
+        hash &*= prime3
+        hash ^= hash >> 32
+        return hash
+    }
+
+    private static func round(_ accumulator: UInt64, _ input: UInt64) -> UInt64 {
+        return rotate(accumulator &+ input &* prime2, 31) &* prime1
+    }
+
+    private static func rotate(_ value: UInt64, _ count: UInt64) -> UInt64 {
+        return value << count | value >> (64 - count)
+    }
+}
+
+private var contentHashKey: UInt8 = 0
+
+extension PTDiffusionBytes {
+    /**
+     A 64-bit hash of the receiver's bytes.
+
+     The hash is computed on first use and cached on the receiver, which is
+     immutable. Equal contents always have equal hashes; unequal contents
+     have equal hashes only by a very unlikely collision.
+     */
+    public var contentHash: UInt64 {
+        if let cached = objc_getAssociatedObject(self, &contentHashKey) as? NSNumber {
+            return cached.uint64Value
+        }
+        let hash = data.withUnsafeBytes { ContentHash.hash($0) }
+        objc_setAssociatedObject(self, &contentHashKey, NSNumber(value: hash), .OBJC_ASSOCIATION_RETAIN_NONATOMIC)
+        return hash
+    }
+
+    /// Returns the receiver's content hash if it has already been computed.
+    var cachedContentHash: UInt64? {
+        return (objc_getAssociatedObject(self, &contentHashKey) as? NSNumber)?.uint64Value
+    }
+
+    /**
+     Returns `true` if the receiver holds the same bytes as the given value.
+
+     Unlike `isEqualToBytes:`, this returns without comparing the bytes when
+     the values differ in length or both have cached content hashes that
+     differ.
+     */
+    public func hasSameContent(as other: PTDiffusionBytes) -> Bool {
+        if self === other {
+            return true
+        }
+        let data = self.data
+        let otherData = other.data
+        guard data.count == otherData.count else {
+            return false
+        }
+        if let hash = cachedContentHash, let otherHash = other.cachedContentHash, hash != otherHash {
+            return false
+        }
+        return data == otherData
+    }
+}
+
+extension PTDiffusionJSONUpdateStream {
+    /**
+     Sets the topic to the given value unless it has the same content as the
+     last value set through the stream.
+
+     Repeated values are dropped before they reach the session, so they
+     cost no network traffic. The check is `hasSameContent(as:)`: values of
+     a different length are set at once, and values of the same length are
+     compared byte by byte, stopping at the first difference. Content hashes
+     are used only if both values already have them cached, as computing one
+     would read the whole value before the comparison could begin.
+
+     - Returns: `true` if the value was set, or `false` if it was dropped,
+       in which case the completion handler is not called.
+
+     - Throws: The error raised by `setValue:completionHandler:error:`.
+     */
+    @discardableResult
+    public func setValueIfChanged(_ value: PTDiffusionJSON,
+                                  completionHandler: @escaping PTDiffusionUpdateStreamHandlerBlock) throws -> Bool {
+        // The stream has no value until one is set, whatever its nullability.
+        if let current = self.value(forKey: "value") as? PTDiffusionJSON,
+           current.hasSameContent(as: value) {
+            return false
+        }
+        try setValue(value, completionHandler: completionHandler)
+        return true
+    }
+}
+
+extension PTDiffusionBinaryUpdateStream {
+    /**
+     Sets the topic to the given value unless it has the same content as the
+     last value set through the stream.
+
+     - Returns: `true` if the value was set, or `false` if it was dropped,
+       in which case the completion handler is not called.
+
+     - Throws: The error raised by `setValue:completionHandler:error:`.
+
+     - SeeAlso: `PTDiffusionJSONUpdateStream.setValueIfChanged(_:completionHandler:)`
+     */
+    @discardableResult
+    public func setValueIfChanged(_ value: PTDiffusionBinary,
+                                  completionHandler: @escaping PTDiffusionUpdateStreamHandlerBlock) throws -> Bool {
+        if let current = self.value(forKey: "value") as? PTDiffusionBinary,
+           current.hasSameContent(as: value) {
+            return false
+        }
+        try setValue(value, completionHandler: completionHandler)
+        return true
+    }
+}
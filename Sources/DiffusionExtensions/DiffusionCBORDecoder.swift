@@ -0,0 +1,705 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Decodes `Decodable` values directly from the CBOR representation used by
+ `PTDiffusionJSON`, without first building Foundation objects.
+
+ Values are read in place from the CBOR bytes. Each map is indexed once,
+ when its keyed container is created, and the keys of maps decoded with a
+ fixed set of coding keys are interned so that decoding a sequence of
+ similar values does not allocate a string per key. Keys of maps decoded
+ as dictionaries are data rather than field names and are not interned.
+
+ Integers may be decoded from floats with an integral value, and floating
+ point types from integers, as with `JSONDecoder`. `URL` values are decoded
+ from strings and `Decimal` values from numbers, matching
+ `DiffusionCBOREncoder`.
+ */
+public final class DiffusionCBORDecoder {
+    /// Contextual information made available to values as they are decoded.
+    public var userInfo: [CodingUserInfoKey: Any] = [:]
+
+    let keys = CBORStringTable()
+
+    public init() {
+    }
+
+    /**
+     Returns a value of the given type decoded from CBOR.
+
+     A decoder interns map keys across calls, so reusing one decoder for
+     successive values is cheaper than creating a decoder per value. A
+     decoder is not thread safe.
+
+     - Throws: `DecodingError` if the data is not well formed CBOR, or does
+       not match the type.
+     */
+    public func decode<T: Decodable>(_ type: T.Type, from data: Data) throws -> T {
+        return try data.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            try validate(&reader)
+            guard reader.isAtEnd else {
+                throw DecodingError.dataCorrupted(
+                    DecodingError.Context(codingPath: [],
+                                          debugDescription: "Unexpected bytes after the top-level value."))
+            }
+            return try decodeValidated(type, in: buffer, at: 0)
+        }
+    }
+
+    /// Decodes the data item at `offset` within the buffer, ignoring any
+    /// bytes that follow it.
+    func decode<T: Decodable>(_ type: T.Type, in buffer: UnsafeRawBufferPointer, at offset: Int) throws -> T {
+        var reader = CBORReader(buffer, offset: offset)
+        try validate(&reader)
+        return try decodeValidated(type, in: buffer, at: offset)
+    }
+
+    private func decodeValidated<T: Decodable>(_ type: T.Type,
+                                               in buffer: UnsafeRawBufferPointer,
+                                               at offset: Int) throws -> T {
+        let decoder = CBORDecoderImpl(buffer: buffer,
+                                      offset: offset,
+                                      codingPath: [],
+                                      userInfo: userInfo,
+                                      keys: keys)
+        return try decoder.unbox(T.self, at: offset, key: nil)
+    }
+
+    private func validate(_ reader: inout CBORReader) throws {
+        do {
+            try reader.skipItem()
+        } catch {
+            throw DecodingError.dataCorrupted(
+                DecodingError.Context(codingPath: [],
+                                      debugDescription: "The given data was not valid CBOR.",
+                                      underlyingError: error))
+        }
+    }
+
+    /**
+     Returns a value of the given type decoded from the CBOR held by a JSON
+     value.
+     */
+    public func decode<T: Decodable>(_ type: T.Type, from json: PTDiffusionJSON) throws -> T {
+        return try decode(type, from: json.data)
+    }
+}
+
+extension PTDiffusionJSON {
+    /**
+     Returns the receiver's value decoded as the given `Decodable` type.
+     */
+    public func decode<T: Decodable>(_ type: T.Type,
+                                     decoder: DiffusionCBORDecoder = DiffusionCBORDecoder()) throws -> T {
+        return try decoder.decode(type, from: self)
+    }
+}
+
+// MARK: - Decoder
+
+/// Decodes the item at `offset`. The buffer has already been checked to be
+/// well formed, so `CBORError` can only arise here from invalid UTF-8.
+final class CBORDecoderImpl: Decoder {
+    let buffer: UnsafeRawBufferPointer
+    let offset: Int
+    let codingPath: [CodingKey]
+    let userInfo: [CodingUserInfoKey: Any]
+    let keys: CBORStringTable
+
+    init(buffer: UnsafeRawBufferPointer,
+         offset: Int,
+         codingPath: [CodingKey],
+         userInfo: [CodingUserInfoKey: Any],
+         keys: CBORStringTable) {
+        self.buffer = buffer
+        self.offset = offset
+        self.codingPath = codingPath
+        self.userInfo = userInfo
+        self.keys = keys
+    }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) throws -> KeyedDecodingContainer<Key> {
+        var reader = CBORReader(buffer, offset: offset)
+        let count: Int?
+        switch try token(&reader, key: nil) {
+        case .map(let mapCount):
+            count = mapCount
+        case let other:
+            throw typeMismatch([String: Any].self, other, key: nil)
+        }
+        // Key types that accept any string, such as the one used to decode a
+        // dictionary, name data rather than fields, which would soon fill the
+        // table and stop field names being interned.
+        let interning = Key(stringValue: CBORDecoderImpl.arbitraryKey) == nil
+        var offsets = [String: Int]()
+        if let count = count {
+            offsets.reserveCapacity(count)
+        }
+        var index = 0
+        while reader.hasItem(count: count, index: index) {
+            let keyOffset = reader.offset
+            guard case .text(let range) = try token(&reader, key: nil) else {
+                throw DecodingError.dataCorrupted(
+                    DecodingError.Context(codingPath: codingPath,
+                                          debugDescription: "Map key at offset \(keyOffset) is not a definite length text string."))
+            }
+            let key = try string(reader, range, key: nil, interning: interning)
+            offsets[key] = reader.offset
+            try reader.skipItem()
+            index += 1
+        }
+        return KeyedDecodingContainer(CBORKeyedDecodingContainer<Key>(decoder: self, offsets: offsets))
+    }
+
+    /// A string that no fixed set of coding keys is expected to accept.
+    private static let arbitraryKey = "\u{0}DiffusionCBORDecoder.arbitraryKey"
+
+    func unkeyedContainer() throws -> UnkeyedDecodingContainer {
+        var reader = CBORReader(buffer, offset: offset)
+        switch try token(&reader, key: nil) {
+        case .array(let count):
+            return CBORUnkeyedDecodingContainer(decoder: self, reader: reader, count: count)
+        case let other:
+            throw typeMismatch([Any].self, other, key: nil)
+        }
+    }
+
+    func singleValueContainer() throws -> SingleValueDecodingContainer {
+        return self
+    }
+
+    // MARK: Unboxing
+
+    func path(_ key: CodingKey?) -> [CodingKey] {
+        return key.map { codingPath + [$0] } ?? codingPath
+    }
+
+    /// Reads the next token, skipping any tags.
+    func token(_ reader: inout CBORReader, key: CodingKey?) throws -> CBORToken {
+        do {
+            var token = try reader.next()
+            while case .tag = token {
+                token = try reader.next()
+            }
+            return token
+        } catch {
+            throw DecodingError.dataCorrupted(
+                DecodingError.Context(codingPath: path(key),
+                                      debugDescription: "The given data was not valid CBOR.",
+                                      underlyingError: error))
+        }
+    }
+
+    func token(at offset: Int, key: CodingKey?) throws -> CBORToken {
+        var reader = CBORReader(buffer, offset: offset)
+        return try token(&reader, key: key)
+    }
+
+    func typeMismatch(_ type: Any.Type, _ token: CBORToken, key: CodingKey?) -> DecodingError {
+        return DecodingError.typeMismatch(
+            type,
+            DecodingError.Context(codingPath: path(key),
+                                  debugDescription: "Expected to decode \(type) but found \(token) instead."))
+    }
+
+    func isNil(at offset: Int) throws -> Bool {
+        switch try token(at: offset, key: nil) {
+        case .null, .undefined:
+            return true
+        default:
+            return false
+        }
+    }
+
+    func unbox<T: Decodable>(_ type: T.Type, at offset: Int, key: CodingKey?) throws -> T {
+        if T.self == String.self {
+            return try unboxString(at: offset, key: key) as! T
+        }
+        if T.self == Int.self {
+            return try unboxInteger(Int.self, at: offset, key: key) as! T
+        }
+        if T.self == Double.self {
+            return try unboxFloatingPoint(Double.self, at: offset, key: key) as! T
+        }
+        if T.self == Bool.self {
+            return try unboxBool(at: offset, key: key) as! T
+        }
+        if T.self == Data.self {
+            return try unboxData(at: offset, key: key) as! T
+        }
+        if T.self == URL.self {
+            return try unboxURL(at: offset, key: key) as! T
+        }
+        if T.self == Decimal.self {
+            return try unboxDecimal(at: offset, key: key) as! T
+        }
+        return try T(from: key.map { child(at: offset, key: $0) } ?? self)
+    }
+
+    /// Returns a decoder for the item at `offset`, nested under `key`.
+    func child(at offset: Int, key: CodingKey) -> CBORDecoderImpl {
+        return CBORDecoderImpl(buffer: buffer,
+                               offset: offset,
+                               codingPath: codingPath + [key],
+                               userInfo: userInfo,
+                               keys: keys)
+    }
+
+    func unboxBool(at offset: Int, key: CodingKey?) throws -> Bool {
+        let token = try self.token(at: offset, key: key)
+        guard case .bool(let value) = token else {
+            throw typeMismatch(Bool.self, token, key: key)
+        }
+        return value
+    }
+
+    func unboxInteger<T: FixedWidthInteger>(_ type: T.Type, at offset: Int, key: CodingKey?) throws -> T {
+        let token = try self.token(at: offset, key: key)
+        let value: T?
+        switch token {
+        case .unsigned(let magnitude):
+            value = T(exactly: magnitude)
+        case .negative(let argument):
+            value = argument <= UInt64(Int64.max) ? T(exactly: -1 - Int64(argument)) : nil
+        case .float(let double):
+            value = T(exactly: double)
+        default:
+            throw typeMismatch(T.self, token, key: key)
+        }
+        guard let result = value else {
+            throw DecodingError.dataCorrupted(
+                DecodingError.Context(codingPath: path(key),
+                                      debugDescription: "Parsed CBOR number <\(token)> does not fit in \(T.self)."))
+        }
+        return result
+    }
+
+    func unboxFloatingPoint<T: BinaryFloatingPoint>(_ type: T.Type, at offset: Int, key: CodingKey?) throws -> T {
+        let token = try self.token(at: offset, key: key)
+        let double: Double
+        switch token {
+        case .float(let value):
+            double = value
+        case .unsigned(let magnitude):
+            double = Double(magnitude)
+        case .negative(let argument):
+            double = -1 - Double(argument)
+        default:
+            throw typeMismatch(T.self, token, key: key)
+        }
+        let result = T(double)
+        guard result.isFinite || !double.isFinite else {
+            throw DecodingError.dataCorrupted(
+                DecodingError.Context(codingPath: path(key),
+                                      debugDescription: "Parsed CBOR number <\(double)> does not fit in \(T.self)."))
+        }
+        return result
+    }
+
+    /// Decodes a decimal from any number. Floats are converted through their
+    /// shortest decimal representation, as `JSONDecoder` reads the JSON text.
+    func unboxDecimal(at offset: Int, key: CodingKey?) throws -> Decimal {
+        let token = try self.token(at: offset, key: key)
+        switch token {
+        case .unsigned(let magnitude):
+            return Decimal(magnitude)
+        case .negative(let argument):
+            return -1 - Decimal(argument)
+        case .float(let double):
+            guard double.isFinite, let decimal = Decimal(string: "\(double)") else {
+                throw DecodingError.dataCorrupted(
+                    DecodingError.Context(codingPath: path(key),
+                                          debugDescription: "Parsed CBOR number <\(double)> does not fit in Decimal."))
+            }
+            return decimal
+        default:
+            throw typeMismatch(Decimal.self, token, key: key)
+        }
+    }
+
+    /// Decodes a URL from its string, as `JSONDecoder` does.
+    func unboxURL(at offset: Int, key: CodingKey?) throws -> URL {
+        let string = try unboxString(at: offset, key: key)
+        guard let url = URL(string: string) else {
+            throw DecodingError.dataCorrupted(
+                DecodingError.Context(codingPath: path(key),
+                                      debugDescription: "Invalid URL string."))
+        }
+        return url
+    }
+
+    func unboxString(at offset: Int, key: CodingKey?) throws -> String {
+        var reader = CBORReader(buffer, offset: offset)
+        let token = try self.token(&reader, key: key)
+        switch token {
+        case .text(let range):
+            return try string(reader, range, key: key, interning: false)
+        case .indefiniteText:
+            var result = ""
+            while !reader.consumeBreak() {
+                guard case .text(let range) = try self.token(&reader, key: key) else {
+                    throw typeMismatch(String.self, token, key: key)
+                }
+                result += try string(reader, range, key: key, interning: false)
+            }
+            return result
+        default:
+            throw typeMismatch(String.self, token, key: key)
+        }
+    }
+
+    func unboxData(at offset: Int, key: CodingKey?) throws -> Data {
+        var reader = CBORReader(buffer, offset: offset)
+        let token = try self.token(&reader, key: key)
+        switch token {
+        case .bytes(let range):
+            return Data(reader.slice(range))
+        case .indefiniteBytes:
+            var result = Data()
+            while !reader.consumeBreak() {
+                guard case .bytes(let range) = try self.token(&reader, key: key) else {
+                    throw typeMismatch(Data.self, token, key: key)
+                }
+                result.append(contentsOf: reader.slice(range))
+            }
+            return result
+        default:
+            throw typeMismatch(Data.self, token, key: key)
+        }
+    }
+
+    private func string(_ reader: CBORReader,
+                        _ range: Range<Int>,
+                        key: CodingKey?,
+                        interning: Bool) throws -> String {
+        do {
+            return try reader.validatedString(range, interning: interning ? keys : nil)
+        } catch {
+            throw DecodingError.dataCorrupted(
+                DecodingError.Context(codingPath: path(key),
+                                      debugDescription: "The given data contained invalid UTF-8.",
+                                      underlyingError: error))
+        }
+    }
+}
+
+extension CBORDecoderImpl: SingleValueDecodingContainer {
+    func decodeNil() -> Bool {
+        return (try? isNil(at: offset)) ?? false
+    }
+
+    func decode(_ type: Bool.Type) throws -> Bool {
+        return try unboxBool(at: offset, key: nil)
+    }
+
+    func decode(_ type: String.Type) throws -> String {
+        return try unboxString(at: offset, key: nil)
+    }
+
+    func decode(_ type: Double.Type) throws -> Double {
+        return try unboxFloatingPoint(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: Float.Type) throws -> Float {
+        return try unboxFloatingPoint(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: Int.Type) throws -> Int {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: Int8.Type) throws -> Int8 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: Int16.Type) throws -> Int16 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: Int32.Type) throws -> Int32 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: Int64.Type) throws -> Int64 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: UInt.Type) throws -> UInt {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: UInt8.Type) throws -> UInt8 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: UInt16.Type) throws -> UInt16 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: UInt32.Type) throws -> UInt32 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode(_ type: UInt64.Type) throws -> UInt64 {
+        return try unboxInteger(type, at: offset, key: nil)
+    }
+
+    func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        return try unbox(type, at: offset, key: nil)
+    }
+}
+
+struct CBORKeyedDecodingContainer<Key: CodingKey>: KeyedDecodingContainerProtocol {
+    let decoder: CBORDecoderImpl
+    let offsets: [String: Int]
+
+    var codingPath: [CodingKey] {
+        return decoder.codingPath
+    }
+
+    var allKeys: [Key] {
+        return offsets.keys.compactMap { Key(stringValue: $0) }
+    }
+
+    func contains(_ key: Key) -> Bool {
+        return offsets[key.stringValue] != nil
+    }
+
+    private func offset(_ key: Key) throws -> Int {
+        guard let offset = offsets[key.stringValue] else {
+            throw DecodingError.keyNotFound(
+                key,
+                DecodingError.Context(codingPath: codingPath,
+                                      debugDescription: "No value associated with key \(key.stringValue)."))
+        }
+        return offset
+    }
+
+    func decodeNil(forKey key: Key) throws -> Bool {
+        return try decoder.isNil(at: offset(key))
+    }
+
+    func decode(_ type: Bool.Type, forKey key: Key) throws -> Bool {
+        return try decoder.unboxBool(at: offset(key), key: key)
+    }
+
+    func decode(_ type: String.Type, forKey key: Key) throws -> String {
+        return try decoder.unboxString(at: offset(key), key: key)
+    }
+
+    func decode(_ type: Double.Type, forKey key: Key) throws -> Double {
+        return try decoder.unboxFloatingPoint(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: Float.Type, forKey key: Key) throws -> Float {
+        return try decoder.unboxFloatingPoint(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: Int.Type, forKey key: Key) throws -> Int {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: Int8.Type, forKey key: Key) throws -> Int8 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: Int16.Type, forKey key: Key) throws -> Int16 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: Int32.Type, forKey key: Key) throws -> Int32 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: Int64.Type, forKey key: Key) throws -> Int64 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: UInt.Type, forKey key: Key) throws -> UInt {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: UInt8.Type, forKey key: Key) throws -> UInt8 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: UInt16.Type, forKey key: Key) throws -> UInt16 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: UInt32.Type, forKey key: Key) throws -> UInt32 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode(_ type: UInt64.Type, forKey key: Key) throws -> UInt64 {
+        return try decoder.unboxInteger(type, at: offset(key), key: key)
+    }
+
+    func decode<T: Decodable>(_ type: T.Type, forKey key: Key) throws -> T {
+        return try decoder.unbox(type, at: offset(key), key: key)
+    }
+
+    func nestedContainer<NestedKey: CodingKey>(keyedBy type: NestedKey.Type,
+                                               forKey key: Key) throws -> KeyedDecodingContainer<NestedKey> {
+        return try child(key).container(keyedBy: type)
+    }
+
+    func nestedUnkeyedContainer(forKey key: Key) throws -> UnkeyedDecodingContainer {
+        return try child(key).unkeyedContainer()
+    }
+
+    func superDecoder() throws -> Decoder {
+        return try child(CBORSuperKey(), offset: offsets[CBORSuperKey().stringValue])
+    }
+
+    func superDecoder(forKey key: Key) throws -> Decoder {
+        return try child(key)
+    }
+
+    private func child(_ key: Key) throws -> CBORDecoderImpl {
+        return try child(key, offset: offset(key))
+    }
+
+    private func child(_ key: CodingKey, offset: Int?) throws -> CBORDecoderImpl {
+        guard let offset = offset else {
+            throw DecodingError.keyNotFound(
+                key,
+                DecodingError.Context(codingPath: codingPath,
+                                      debugDescription: "No value associated with key \(key.stringValue)."))
+        }
+        return decoder.child(at: offset, key: key)
+    }
+}
+
+struct CBORUnkeyedDecodingContainer: UnkeyedDecodingContainer {
+    let decoder: CBORDecoderImpl
+
+    /// Positioned at the next element, or the break marker of an indefinite
+    /// length array.
+    private var reader: CBORReader
+
+    let count: Int?
+    private(set) var currentIndex = 0
+
+    init(decoder: CBORDecoderImpl, reader: CBORReader, count: Int?) {
+        self.decoder = decoder
+        self.reader = reader
+        self.count = count
+    }
+
+    var codingPath: [CodingKey] {
+        return decoder.codingPath
+    }
+
+    var isAtEnd: Bool {
+        if let count = count {
+            return currentIndex >= count
+        }
+        return reader.isAtBreak
+    }
+
+    /// Decodes the next element with `body`, then moves past it.
+    private mutating func next<T>(_ type: T.Type,
+                                  _ body: (CBORDecoderImpl, Int, CodingKey) throws -> T) throws -> T {
+        let key = CBORIndexKey(currentIndex)
+        guard !isAtEnd else {
+            throw DecodingError.valueNotFound(
+                type,
+                DecodingError.Context(codingPath: codingPath + [key],
+                                      debugDescription: "Unkeyed container is at end."))
+        }
+        let value = try body(decoder, reader.offset, key)
+        try reader.skipItem()
+        currentIndex += 1
+        return value
+    }
+
+    mutating func decodeNil() throws -> Bool {
+        guard !isAtEnd, try decoder.isNil(at: reader.offset) else {
+            return false
+        }
+        try reader.skipItem()
+        currentIndex += 1
+        return true
+    }
+
+    mutating func decode(_ type: Bool.Type) throws -> Bool {
+        return try next(type) { try $0.unboxBool(at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: String.Type) throws -> String {
+        return try next(type) { try $0.unboxString(at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Double.Type) throws -> Double {
+        return try next(type) { try $0.unboxFloatingPoint(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Float.Type) throws -> Float {
+        return try next(type) { try $0.unboxFloatingPoint(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Int.Type) throws -> Int {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Int8.Type) throws -> Int8 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Int16.Type) throws -> Int16 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Int32.Type) throws -> Int32 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: Int64.Type) throws -> Int64 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: UInt.Type) throws -> UInt {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: UInt8.Type) throws -> UInt8 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: UInt16.Type) throws -> UInt16 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: UInt32.Type) throws -> UInt32 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode(_ type: UInt64.Type) throws -> UInt64 {
+        return try next(type) { try $0.unboxInteger(type, at: $1, key: $2) }
+    }
+
+    mutating func decode<T: Decodable>(_ type: T.Type) throws -> T {
+        return try next(type) { try $0.unbox(type, at: $1, key: $2) }
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(keyedBy type: NestedKey.Type) throws -> KeyedDecodingContainer<NestedKey> {
+        return try next(KeyedDecodingContainer<NestedKey>.self) { try $0.child(at: $1, key: $2).container(keyedBy: type) }
+    }
+
+    mutating func nestedUnkeyedContainer() throws -> UnkeyedDecodingContainer {
+        return try next(UnkeyedDecodingContainer.self) { try $0.child(at: $1, key: $2).unkeyedContainer() }
+    }
+
+    mutating func superDecoder() throws -> Decoder {
+        return try next(Decoder.self) { $0.child(at: $1, key: $2) }
+    }
+}
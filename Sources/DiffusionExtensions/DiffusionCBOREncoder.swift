@@ -0,0 +1,574 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Encodes `Encodable` values directly to the CBOR representation used by
+ `PTDiffusionJSON`, without boxing them into Foundation objects first.
+
+ `Data` values are encoded as CBOR byte strings. All other values are encoded
+ as they would be by `JSONEncoder` with its default strategies, so the result
+ can be read by clients written in other languages: `URL` values as their
+ absolute strings, `Decimal` values as numbers, and non-finite floating point
+ values are rejected.
+ */
+public final class DiffusionCBOREncoder {
+    /// Contextual information made available to values as they are encoded.
+    public var userInfo: [CodingUserInfoKey: Any] = [:]
+
+    public init() {
+    }
+
+    /**
+     Returns the CBOR encoding of the given value.
+
+     - Throws: `EncodingError` if the value cannot be encoded.
+     */
+    public func encode<T: Encodable>(_ value: T) throws -> Data {
+        let encoder = CBOREncoderImpl(codingPath: [], userInfo: userInfo)
+        let node = try encoder.box(value, at: [])
+        return CBORWriter.data(count: node.size) { writer in
+            node.write(to: &writer)
+        }
+    }
+
+    /**
+     Returns a JSON value holding the CBOR encoding of the given value.
+
+     - Throws: `EncodingError` if the value cannot be encoded.
+     */
+    public func encodeJSON<T: Encodable>(_ value: T) throws -> PTDiffusionJSON {
+        return PTDiffusionJSON(data: try encode(value))
+    }
+}
+
+extension PTDiffusionJSON {
+    /**
+     Returns a JSON value initialized with the CBOR encoding of the given
+     `Encodable` value.
+     */
+    public convenience init<T: Encodable>(encoding value: T,
+                                          encoder: DiffusionCBOREncoder = DiffusionCBOREncoder()) throws {
+        let data = try encoder.encode(value)
+        self.init(data: data)
+    }
+}
+
+// MARK: - Encoded value tree
+
+/// The values written by an encoder, held until the whole tree is complete so
+/// that the exact encoded size, including every container's length, is known
+/// before anything is written.
+enum CBORNode {
+    case unsigned(UInt64)
+    case negative(UInt64)
+    case double(Double)
+    case bool(Bool)
+    case null
+    case text(String)
+    case bytes(Data)
+    case array(CBORArrayStorage)
+    case map(CBORMapStorage)
+    /// The value written to a super encoder, resolved when the tree is written.
+    case deferred(CBOREncoderImpl)
+
+    static func integer<T: BinaryInteger>(_ value: T) -> CBORNode {
+        return value < 0 ? .negative(UInt64(~Int64(value))) : .unsigned(UInt64(value))
+    }
+
+    /// Returns the node for a floating point value, which must be finite as
+    /// JSON cannot represent infinities or NaN.
+    static func floatingPoint(_ value: Double, at codingPath: [CodingKey]) throws -> CBORNode {
+        guard value.isFinite else {
+            throw EncodingError.invalidValue(
+                value,
+                EncodingError.Context(codingPath: codingPath,
+                                      debugDescription: "Unable to encode \(value) directly in JSON."))
+        }
+        return .double(value)
+    }
+
+    /// Returns the node for a decimal value: an integer if it is integral and
+    /// fits in 64 bits, otherwise the nearest double, as the JSON number that
+    /// `JSONEncoder` writes would be read.
+    static func decimal(_ value: Decimal, at codingPath: [CodingKey]) throws -> CBORNode {
+        guard value.isFinite else {
+            throw EncodingError.invalidValue(
+                value,
+                EncodingError.Context(codingPath: codingPath,
+                                      debugDescription: "Unable to encode \(value) directly in JSON."))
+        }
+        let text = value.description
+        if let integer = Int64(text) {
+            return .integer(integer)
+        }
+        if let integer = UInt64(text) {
+            return .unsigned(integer)
+        }
+        return try floatingPoint(Double(text) ?? NSDecimalNumber(decimal: value).doubleValue, at: codingPath)
+    }
+
+    var size: Int {
+        switch self {
+        case .unsigned(let value), .negative(let value):
+            return CBORWriter.costOfHead(value)
+        case .double:
+            return CBORWriter.costOfDouble
+        case .bool, .null:
+            return CBORWriter.costOfSimpleValue
+        case .text(let string):
+            return CBORWriter.cost(ofTextWithUTF8Count: string.utf8.count)
+        case .bytes(let data):
+            return CBORWriter.cost(ofBytesWithCount: data.count)
+        case .array(let storage):
+            var size = CBORWriter.costOfHead(UInt64(storage.elements.count))
+            for element in storage.elements {
+                size += element.size
+            }
+            return size
+        case .map(let storage):
+            var size = CBORWriter.costOfHead(UInt64(storage.entries.count))
+            for (key, value) in storage.entries {
+                size += CBORWriter.cost(ofTextWithUTF8Count: key.utf8.count) + value.size
+            }
+            return size
+        case .deferred(let encoder):
+            return encoder.resolvedNode.size
+        }
+    }
+
+    func write(to writer: inout CBORWriter) {
+        switch self {
+        case .unsigned(let value):
+            writer.writeUnsigned(value)
+        case .negative(let argument):
+            writer.writeNegative(argument)
+        case .double(let value):
+            writer.writeDouble(value)
+        case .bool(let value):
+            writer.writeBool(value)
+        case .null:
+            writer.writeNull()
+        case .text(let string):
+            writer.writeText(string)
+        case .bytes(let data):
+            data.withUnsafeBytes { writer.writeBytes($0) }
+        case .array(let storage):
+            writer.writeArrayHeader(count: storage.elements.count)
+            for element in storage.elements {
+                element.write(to: &writer)
+            }
+        case .map(let storage):
+            writer.writeMapHeader(count: storage.entries.count)
+            for (key, value) in storage.entries {
+                writer.writeText(key)
+                value.write(to: &writer)
+            }
+        case .deferred(let encoder):
+            encoder.resolvedNode.write(to: &writer)
+        }
+    }
+}
+
+final class CBORArrayStorage {
+    var elements = [CBORNode]()
+}
+
+final class CBORMapStorage {
+    private(set) var entries = [(String, CBORNode)]()
+    private var indexes = [String: Int]()
+
+    /// Sets the value for a key. A key that is encoded again keeps its
+    /// position and takes the new value, as with `JSONEncoder`, so the map
+    /// never has duplicate keys.
+    func set(_ node: CBORNode, for key: String) {
+        if let index = indexes[key] {
+            entries[index].1 = node
+        } else {
+            indexes[key] = entries.count
+            entries.append((key, node))
+        }
+    }
+}
+
+/// The key used in coding paths for the elements of unkeyed containers.
+struct CBORIndexKey: CodingKey {
+    let intValue: Int?
+    let stringValue: String
+
+    init(_ index: Int) {
+        self.intValue = index
+        self.stringValue = "Index \(index)"
+    }
+
+    init?(stringValue: String) {
+        return nil
+    }
+
+    init?(intValue: Int) {
+        self.init(intValue)
+    }
+}
+
+/// The key used in coding paths for super encoders and decoders.
+struct CBORSuperKey: CodingKey {
+    let stringValue = "super"
+    let intValue: Int? = nil
+
+    init() {
+    }
+
+    init?(stringValue: String) {
+        return nil
+    }
+
+    init?(intValue: Int) {
+        return nil
+    }
+}
+
+// MARK: - Encoder
+
+final class CBOREncoderImpl: Encoder {
+    let codingPath: [CodingKey]
+    let userInfo: [CodingUserInfoKey: Any]
+    var node: CBORNode?
+
+    init(codingPath: [CodingKey], userInfo: [CodingUserInfoKey: Any]) {
+        self.codingPath = codingPath
+        self.userInfo = userInfo
+    }
+
+    /// The encoded value, which is an empty map if nothing was encoded, as
+    /// for `JSONEncoder`.
+    var resolvedNode: CBORNode {
+        return node ?? .map(CBORMapStorage())
+    }
+
+    func container<Key: CodingKey>(keyedBy type: Key.Type) -> KeyedEncodingContainer<Key> {
+        let storage: CBORMapStorage
+        if case .map(let existing)? = node {
+            storage = existing
+        } else {
+            storage = CBORMapStorage()
+            node = .map(storage)
+        }
+        return KeyedEncodingContainer(CBORKeyedEncodingContainer<Key>(encoder: self,
+                                                                      storage: storage,
+                                                                      codingPath: codingPath))
+    }
+
+    func unkeyedContainer() -> UnkeyedEncodingContainer {
+        let storage: CBORArrayStorage
+        if case .array(let existing)? = node {
+            storage = existing
+        } else {
+            storage = CBORArrayStorage()
+            node = .array(storage)
+        }
+        return CBORUnkeyedEncodingContainer(encoder: self, storage: storage, codingPath: codingPath)
+    }
+
+    func singleValueContainer() -> SingleValueEncodingContainer {
+        return self
+    }
+
+    /// Returns the node for a value, avoiding a nested encoder for the common
+    /// primitive types.
+    func box<T: Encodable>(_ value: T, at codingPath: [CodingKey]) throws -> CBORNode {
+        switch value {
+        case let string as String:
+            return .text(string)
+        case let integer as Int:
+            return .integer(integer)
+        case let double as Double:
+            return try .floatingPoint(double, at: codingPath)
+        case let bool as Bool:
+            return .bool(bool)
+        case let data as Data:
+            return .bytes(data)
+        case let url as URL:
+            return .text(url.absoluteString)
+        case let decimal as Decimal:
+            return try .decimal(decimal, at: codingPath)
+        default:
+            let encoder = CBOREncoderImpl(codingPath: codingPath, userInfo: userInfo)
+            try value.encode(to: encoder)
+            return encoder.resolvedNode
+        }
+    }
+}
+
+extension CBOREncoderImpl: SingleValueEncodingContainer {
+    func encodeNil() throws {
+        node = .null
+    }
+
+    func encode(_ value: Bool) throws {
+        node = .bool(value)
+    }
+
+    func encode(_ value: String) throws {
+        node = .text(value)
+    }
+
+    func encode(_ value: Double) throws {
+        node = try .floatingPoint(value, at: codingPath)
+    }
+
+    func encode(_ value: Float) throws {
+        node = try .floatingPoint(Double(value), at: codingPath)
+    }
+
+    func encode(_ value: Int) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: Int8) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: Int16) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: Int32) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: Int64) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: UInt) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: UInt8) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: UInt16) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: UInt32) throws {
+        node = .integer(value)
+    }
+
+    func encode(_ value: UInt64) throws {
+        node = .integer(value)
+    }
+
+    func encode<T: Encodable>(_ value: T) throws {
+        node = try box(value, at: codingPath)
+    }
+}
+
+struct CBORKeyedEncodingContainer<Key: CodingKey>: KeyedEncodingContainerProtocol {
+    let encoder: CBOREncoderImpl
+    let storage: CBORMapStorage
+    let codingPath: [CodingKey]
+
+    private func set(_ node: CBORNode, for key: CodingKey) {
+        storage.set(node, for: key.stringValue)
+    }
+
+    mutating func encodeNil(forKey key: Key) throws {
+        set(.null, for: key)
+    }
+
+    mutating func encode(_ value: Bool, forKey key: Key) throws {
+        set(.bool(value), for: key)
+    }
+
+    mutating func encode(_ value: String, forKey key: Key) throws {
+        set(.text(value), for: key)
+    }
+
+    mutating func encode(_ value: Double, forKey key: Key) throws {
+        set(try .floatingPoint(value, at: codingPath + [key]), for: key)
+    }
+
+    mutating func encode(_ value: Float, forKey key: Key) throws {
+        set(try .floatingPoint(Double(value), at: codingPath + [key]), for: key)
+    }
+
+    mutating func encode(_ value: Int, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: Int8, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: Int16, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: Int32, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: Int64, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: UInt, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: UInt8, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: UInt16, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: UInt32, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode(_ value: UInt64, forKey key: Key) throws {
+        set(.integer(value), for: key)
+    }
+
+    mutating func encode<T: Encodable>(_ value: T, forKey key: Key) throws {
+        set(try encoder.box(value, at: codingPath + [key]), for: key)
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(keyedBy keyType: NestedKey.Type,
+                                                        forKey key: Key) -> KeyedEncodingContainer<NestedKey> {
+        let nested = CBORMapStorage()
+        set(.map(nested), for: key)
+        return KeyedEncodingContainer(CBORKeyedEncodingContainer<NestedKey>(encoder: encoder,
+                                                                            storage: nested,
+                                                                            codingPath: codingPath + [key]))
+    }
+
+    mutating func nestedUnkeyedContainer(forKey key: Key) -> UnkeyedEncodingContainer {
+        let nested = CBORArrayStorage()
+        set(.array(nested), for: key)
+        return CBORUnkeyedEncodingContainer(encoder: encoder, storage: nested, codingPath: codingPath + [key])
+    }
+
+    mutating func superEncoder() -> Encoder {
+        return superEncoder(for: CBORSuperKey())
+    }
+
+    mutating func superEncoder(forKey key: Key) -> Encoder {
+        return superEncoder(for: key)
+    }
+
+    private func superEncoder(for key: CodingKey) -> Encoder {
+        let child = CBOREncoderImpl(codingPath: codingPath + [key], userInfo: encoder.userInfo)
+        set(.deferred(child), for: key)
+        return child
+    }
+}
+
+struct CBORUnkeyedEncodingContainer: UnkeyedEncodingContainer {
+    let encoder: CBOREncoderImpl
+    let storage: CBORArrayStorage
+    let codingPath: [CodingKey]
+
+    var count: Int {
+        return storage.elements.count
+    }
+
+    private func append(_ node: CBORNode) {
+        storage.elements.append(node)
+    }
+
+    mutating func encodeNil() throws {
+        append(.null)
+    }
+
+    mutating func encode(_ value: Bool) throws {
+        append(.bool(value))
+    }
+
+    mutating func encode(_ value: String) throws {
+        append(.text(value))
+    }
+
+    mutating func encode(_ value: Double) throws {
+        append(try .floatingPoint(value, at: codingPath + [CBORIndexKey(count)]))
+    }
+
+    mutating func encode(_ value: Float) throws {
+        append(try .floatingPoint(Double(value), at: codingPath + [CBORIndexKey(count)]))
+    }
+
+    mutating func encode(_ value: Int) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: Int8) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: Int16) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: Int32) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: Int64) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: UInt) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: UInt8) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: UInt16) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: UInt32) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode(_ value: UInt64) throws {
+        append(.integer(value))
+    }
+
+    mutating func encode<T: Encodable>(_ value: T) throws {
+        append(try encoder.box(value, at: codingPath + [CBORIndexKey(count)]))
+    }
+
+    mutating func nestedContainer<NestedKey: CodingKey>(keyedBy keyType: NestedKey.Type) -> KeyedEncodingContainer<NestedKey> {
+        let path = codingPath + [CBORIndexKey(count)]
+        let nested = CBORMapStorage()
+        append(.map(nested))
+        return KeyedEncodingContainer(CBORKeyedEncodingContainer<NestedKey>(encoder: encoder,
+                                                                            storage: nested,
+                                                                            codingPath: path))
+    }
+
+    mutating func nestedUnkeyedContainer() -> UnkeyedEncodingContainer {
+        let path = codingPath + [CBORIndexKey(count)]
+        let nested = CBORArrayStorage()
+        append(.array(nested))
+        return CBORUnkeyedEncodingContainer(encoder: encoder, storage: nested, codingPath: path)
+    }
+
+    mutating func superEncoder() -> Encoder {
+        let child = CBOREncoderImpl(codingPath: codingPath + [CBORIndexKey(count)], userInfo: encoder.userInfo)
+        append(.deferred(child))
+        return child
+    }
+}
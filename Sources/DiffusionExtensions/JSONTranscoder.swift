@@ -0,0 +1,759 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Errors raised when transcoding between JSON text and CBOR.
+ */
+public enum JSONTranscodingError: Error, Equatable {
+    /// The JSON text is not valid at the given byte offset.
+    case invalidJSON(offset: Int)
+
+    /// The CBOR item at the given offset has no JSON text representation,
+    /// for example a byte string, a non-text map key or a non-finite float.
+    case unsupportedCBOR(offset: Int)
+
+    /// Values were nested more deeply than `CBORReader.maximumDepth`.
+    case nestingTooDeep(offset: Int)
+
+    /// A JSON object has two members with the same name. The offset is that
+    /// of the second name.
+    case duplicateKey(offset: Int)
+}
+
+/**
+ Transcodes directly between JSON text and the CBOR representation used by
+ `PTDiffusionJSON`, without building Foundation objects.
+
+ JSON text is converted in two passes over the input. The first validates it
+ and records the exact encoded size and the length of every array and object;
+ the second writes the CBOR into a single buffer of that size.
+ */
+public enum JSONTranscoder {
+    /**
+     Converts JSON text, encoded as UTF-8, to CBOR.
+
+     Integers that fit in 64 bits are encoded as CBOR integers; other numbers
+     are encoded as double precision floats.
+
+     Objects with duplicate member names are rejected. NSJSONSerialization
+     keeps the last value for such a name, and a CBOR map with duplicate
+     keys is not valid, so there is no result that would agree with
+     `initWithJSONData:error:`.
+
+     - Throws: `JSONTranscodingError` if the text is not valid JSON or has
+       duplicate member names.
+     */
+    public static func cbor(fromJSON json: UnsafeRawBufferPointer) throws -> Data {
+        if let invalid = UTF8Validation.firstInvalidOffset(in: json) {
+            throw JSONTranscodingError.invalidJSON(offset: invalid)
+        }
+        var sizer = JSONSizingSink()
+        var parser = JSONTextParser(json)
+        try parser.parse(into: &sizer)
+        return CBORWriter.data(count: sizer.size) { writer in
+            var sink = JSONWritingSink(writer: writer, counts: sizer.counts)
+            var parser = JSONTextParser(json, checkingKeys: false)
+            // The input has already been parsed successfully.
+            try! parser.parse(into: &sink)
+            writer = sink.writer
+        }
+    }
+
+    public static func cbor(fromJSON json: Data) throws -> Data {
+        return try json.withUnsafeBytes { try cbor(fromJSON: $0) }
+    }
+
+    /**
+     Converts a single CBOR data item to compact JSON text, encoded as UTF-8.
+
+     - Throws: `CBORError` if the CBOR is malformed, or
+       `JSONTranscodingError` if it has no JSON representation.
+     */
+    public static func json(fromCBOR cbor: UnsafeRawBufferPointer) throws -> Data {
+        var reader = CBORReader(cbor)
+        var output = [UInt8]()
+        output.reserveCapacity(cbor.count + cbor.count / 2)
+        try writeJSON(&reader, to: &output, depth: 0)
+        guard reader.isAtEnd else {
+            throw JSONTranscodingError.unsupportedCBOR(offset: reader.offset)
+        }
+        return Data(output)
+    }
+
+    public static func json(fromCBOR cbor: Data) throws -> Data {
+        return try cbor.withUnsafeBytes { try json(fromCBOR: $0) }
+    }
+
+    // MARK: CBOR to JSON
+
+    private static func writeJSON(_ reader: inout CBORReader,
+                                  to output: inout [UInt8],
+                                  depth: Int) throws {
+        let start = reader.offset
+        guard depth < CBORReader.maximumDepth else {
+            throw JSONTranscodingError.nestingTooDeep(offset: start)
+        }
+        switch try reader.next() {
+        case .unsigned(let value):
+            output.append(contentsOf: String(value).utf8)
+        case .negative(let argument):
+            output.append(UInt8(ascii: "-"))
+            if argument == UInt64.max {
+                output.append(contentsOf: "18446744073709551616".utf8)
+            } else {
+                output.append(contentsOf: String(argument + 1).utf8)
+            }
+        case .float(let value):
+            guard value.isFinite else {
+                throw JSONTranscodingError.unsupportedCBOR(offset: start)
+            }
+            output.append(contentsOf: value.description.utf8)
+        case .bool(let value):
+            output.append(contentsOf: (value ? "true" : "false").utf8)
+        case .null:
+            output.append(contentsOf: "null".utf8)
+        case .text(let range):
+            output.append(UInt8(ascii: "\""))
+            try appendEscaped(reader.slice(range), to: &output, offset: range.lowerBound)
+            output.append(UInt8(ascii: "\""))
+        case .indefiniteText:
+            output.append(UInt8(ascii: "\""))
+            while !reader.consumeBreak() {
+                let chunk = reader.offset
+                guard case .text(let range) = try reader.next() else {
+                    throw CBORError.malformed(offset: chunk)
+                }
+                try appendEscaped(reader.slice(range), to: &output, offset: range.lowerBound)
+            }
+            output.append(UInt8(ascii: "\""))
+        case .array(let count):
+            output.append(UInt8(ascii: "["))
+            var index = 0
+            while reader.hasItem(count: count, index: index) {
+                if index > 0 {
+                    output.append(UInt8(ascii: ","))
+                }
+                try writeJSON(&reader, to: &output, depth: depth + 1)
+                index += 1
+            }
+            output.append(UInt8(ascii: "]"))
+        case .map(let count):
+            output.append(UInt8(ascii: "{"))
+            var index = 0
+            while reader.hasItem(count: count, index: index) {
+                if index > 0 {
+                    output.append(UInt8(ascii: ","))
+                }
+                let key = reader.offset
+                guard key < reader.buffer.count, reader.buffer[key] >> 5 == 3 else {
+                    throw JSONTranscodingError.unsupportedCBOR(offset: key)
+                }
+                try writeJSON(&reader, to: &output, depth: depth + 1)
+                output.append(UInt8(ascii: ":"))
+                try writeJSON(&reader, to: &output, depth: depth + 1)
+                index += 1
+            }
+            output.append(UInt8(ascii: "}"))
+        case .tag:
+            try writeJSON(&reader, to: &output, depth: depth + 1)
+        case .break:
+            throw CBORError.unexpectedBreak(offset: start)
+        case .bytes, .indefiniteBytes, .simple, .undefined:
+            throw JSONTranscodingError.unsupportedCBOR(offset: start)
+        }
+    }
+
+    private static let hexDigits = Array("0123456789abcdef".utf8)
+
+    private static func appendEscaped(_ text: UnsafeRawBufferPointer,
+                                      to output: inout [UInt8],
+                                      offset: Int) throws {
+        if let invalid = UTF8Validation.firstInvalidOffset(in: text) {
+            throw CBORError.invalidUTF8(offset: offset + invalid)
+        }
+        var run = 0
+        for index in 0 ..< text.count {
+            let byte = text[index]
+            guard byte < 0x20 || byte == UInt8(ascii: "\"") || byte == UInt8(ascii: "\\") else {
+                continue
+            }
+            output.append(contentsOf: UnsafeRawBufferPointer(rebasing: text[run ..< index]))
+            output.append(UInt8(ascii: "\\"))
+            switch byte {
+            case UInt8(ascii: "\""), UInt8(ascii: "\\"): output.append(byte)
+            case 0x08: output.append(UInt8(ascii: "b"))
+            case 0x0c: output.append(UInt8(ascii: "f"))
+            case 0x0a: output.append(UInt8(ascii: "n"))
+            case 0x0d: output.append(UInt8(ascii: "r"))
+            case 0x09: output.append(UInt8(ascii: "t"))
+            default:
+                output.append(contentsOf: "u00".utf8)
+                output.append(hexDigits[Int(byte >> 4)])
+                output.append(hexDigits[Int(byte & 0xf)])
+            }
+            run = index + 1
+        }
+        output.append(contentsOf: UnsafeRawBufferPointer(rebasing: text[run...]))
+    }
+}
+
+extension PTDiffusionJSON {
+    /**
+     Returns a JSON object initialized with the given JSON text, transcoded
+     directly to CBOR rather than through NSJSONSerialization and
+     Foundation objects as `initWithJSONData:error:` does.
+
+     - Parameter jsonData: JSON text encoded as UTF-8.
+     */
+    public convenience init(transcodingJSONData jsonData: Data) throws {
+        let data = try JSONTranscoder.cbor(fromJSON: jsonData)
+        self.init(data: data)
+    }
+
+    public convenience init(transcodingJSONString jsonString: String) throws {
+        let data = try JSONTranscoder.cbor(fromJSON: Data(jsonString.utf8))
+        self.init(data: data)
+    }
+
+    /**
+     Returns the receiver's value as compact JSON text encoded as UTF-8,
+     transcoded directly from CBOR.
+     */
+    public func transcodedJSONData() throws -> Data {
+        return try JSONTranscoder.json(fromCBOR: data)
+    }
+}
+
+// MARK: - JSON text parsing
+
+/// Receives the values found by `JSONTextParser`.
+protocol JSONTextSink {
+    mutating func beginContainer(isMap: Bool)
+    mutating func endContainer(count: Int)
+    mutating func unsigned(_ value: UInt64)
+    /// A negative integer `-1 - argument`.
+    mutating func negative(_ argument: UInt64)
+    mutating func double(_ value: Double)
+    mutating func bool(_ value: Bool)
+    mutating func null()
+    /// A string whose raw content, between the quotes, still contains any
+    /// escape sequences. `count` is its length in UTF-8 once unescaped.
+    mutating func text(_ raw: UnsafeRawBufferPointer, count: Int, escaped: Bool)
+}
+
+/// Computes the exact CBOR size of a JSON document and the number of items in
+/// each of its containers, in the order that they open.
+struct JSONSizingSink: JSONTextSink {
+    var size = 0
+    var counts = [Int]()
+    private var open = [Int]()
+
+    mutating func beginContainer(isMap: Bool) {
+        open.append(counts.count)
+        counts.append(0)
+    }
+
+    mutating func endContainer(count: Int) {
+        counts[open.removeLast()] = count
+        size += CBORWriter.costOfHead(UInt64(count))
+    }
+
+    mutating func unsigned(_ value: UInt64) {
+        size += CBORWriter.costOfHead(value)
+    }
+
+    mutating func negative(_ argument: UInt64) {
+        size += CBORWriter.costOfHead(argument)
+    }
+
+    mutating func double(_ value: Double) {
+        size += CBORWriter.costOfDouble
+    }
+
+    mutating func bool(_ value: Bool) {
+        size += CBORWriter.costOfSimpleValue
+    }
+
+    mutating func null() {
+        size += CBORWriter.costOfSimpleValue
+    }
+
+    mutating func text(_ raw: UnsafeRawBufferPointer, count: Int, escaped: Bool) {
+        size += CBORWriter.cost(ofTextWithUTF8Count: count)
+    }
+}
+
+/// Writes the CBOR for a JSON document, using the container lengths found by
+/// `JSONSizingSink`.
+struct JSONWritingSink: JSONTextSink {
+    var writer: CBORWriter
+    let counts: [Int]
+    private var nextContainer = 0
+
+    init(writer: CBORWriter, counts: [Int]) {
+        self.writer = writer
+        self.counts = counts
+    }
+
+    mutating func beginContainer(isMap: Bool) {
+        writer.writeHead(major: isMap ? 5 : 4, argument: UInt64(counts[nextContainer]))
+        nextContainer += 1
+    }
+
+    mutating func endContainer(count: Int) {
+    }
+
+    mutating func unsigned(_ value: UInt64) {
+        writer.writeUnsigned(value)
+    }
+
+    mutating func negative(_ argument: UInt64) {
+        writer.writeNegative(argument)
+    }
+
+    mutating func double(_ value: Double) {
+        writer.writeDouble(value)
+    }
+
+    mutating func bool(_ value: Bool) {
+        writer.writeBool(value)
+    }
+
+    mutating func null() {
+        writer.writeNull()
+    }
+
+    mutating func text(_ raw: UnsafeRawBufferPointer, count: Int, escaped: Bool) {
+        guard escaped else {
+            writer.writeText(utf8: raw)
+            return
+        }
+        writer.writeHead(major: 3, argument: UInt64(count))
+        var index = 0
+        var run = 0
+        while index < raw.count {
+            guard raw[index] == UInt8(ascii: "\\") else {
+                index += 1
+                continue
+            }
+            writer.writeRaw(UnsafeRawBufferPointer(rebasing: raw[run ..< index]))
+            // Escapes were validated when sizing.
+            let escape = JSONTextParser.decodeEscape(raw, at: index)!
+            JSONWritingSink.writeUTF8(escape.scalar, to: &writer)
+            index += escape.length
+            run = index
+        }
+        writer.writeRaw(UnsafeRawBufferPointer(rebasing: raw[run...]))
+    }
+
+    private static func writeUTF8(_ scalar: UInt32, to writer: inout CBORWriter) {
+        switch scalar {
+        case 0 ..< 0x80:
+            writer.writeByte(UInt8(scalar))
+        case 0x80 ..< 0x800:
+            writer.writeByte(UInt8(0xc0 | scalar >> 6))
+            writer.writeByte(UInt8(0x80 | scalar & 0x3f))
+        case 0x800 ..< 0x10000:
+            writer.writeByte(UInt8(0xe0 | scalar >> 12))
+            writer.writeByte(UInt8(0x80 | scalar >> 6 & 0x3f))
+            writer.writeByte(UInt8(0x80 | scalar & 0x3f))
+        default:
+            writer.writeByte(UInt8(0xf0 | scalar >> 18))
+            writer.writeByte(UInt8(0x80 | scalar >> 12 & 0x3f))
+            writer.writeByte(UInt8(0x80 | scalar >> 6 & 0x3f))
+            writer.writeByte(UInt8(0x80 | scalar & 0x3f))
+        }
+    }
+}
+
+/// A key of a JSON object, held while the object is parsed so that
+/// duplicates can be found.
+private struct JSONObjectKey {
+    /// The raw content between the quotes.
+    let raw: UnsafeRawBufferPointer
+    let escaped: Bool
+    /// The offset of the opening quote.
+    let offset: Int
+    var hash: UInt64 = 0
+}
+
+/// A validating RFC 8259 parser over UTF-8 JSON text.
+///
+/// Unless `checkingKeys` is `false`, objects with duplicate member names
+/// are rejected. Text that has already been parsed once can skip the check.
+struct JSONTextParser {
+    private let bytes: UnsafeRawBufferPointer
+    private let checkingKeys: Bool
+    private var index = 0
+    /// The keys of the objects being parsed, innermost last.
+    private var keys = [JSONObjectKey]()
+
+    init(_ bytes: UnsafeRawBufferPointer, checkingKeys: Bool = true) {
+        self.bytes = bytes
+        self.checkingKeys = checkingKeys
+    }
+
+    mutating func parse<Sink: JSONTextSink>(into sink: inout Sink) throws {
+        try parseValue(into: &sink, depth: 0)
+        skipWhitespace()
+        guard index == bytes.count else {
+            throw JSONTranscodingError.invalidJSON(offset: index)
+        }
+    }
+
+    private mutating func parseValue<Sink: JSONTextSink>(into sink: inout Sink, depth: Int) throws {
+        skipWhitespace()
+        guard index < bytes.count else {
+            throw JSONTranscodingError.invalidJSON(offset: index)
+        }
+        switch bytes[index] {
+        case UInt8(ascii: "{"):
+            try parseContainer(isMap: true, into: &sink, depth: depth)
+        case UInt8(ascii: "["):
+            try parseContainer(isMap: false, into: &sink, depth: depth)
+        case UInt8(ascii: "\""):
+            try parseString(into: &sink)
+        case UInt8(ascii: "t"):
+            try expect("true")
+            sink.bool(true)
+        case UInt8(ascii: "f"):
+            try expect("false")
+            sink.bool(false)
+        case UInt8(ascii: "n"):
+            try expect("null")
+            sink.null()
+        default:
+            try parseNumber(into: &sink)
+        }
+    }
+
+    private mutating func parseContainer<Sink: JSONTextSink>(isMap: Bool,
+                                                             into sink: inout Sink,
+                                                             depth: Int) throws {
+        guard depth < CBORReader.maximumDepth else {
+            throw JSONTranscodingError.nestingTooDeep(offset: index)
+        }
+        let close = isMap ? UInt8(ascii: "}") : UInt8(ascii: "]")
+        let firstKey = keys.count
+        index += 1
+        sink.beginContainer(isMap: isMap)
+        var count = 0
+        skipWhitespace()
+        if index < bytes.count && bytes[index] == close {
+            index += 1
+            sink.endContainer(count: 0)
+            return
+        }
+        while true {
+            if isMap {
+                skipWhitespace()
+                guard index < bytes.count && bytes[index] == UInt8(ascii: "\"") else {
+                    throw JSONTranscodingError.invalidJSON(offset: index)
+                }
+                let keyOffset = index
+                let key = try parseString(into: &sink)
+                if checkingKeys {
+                    keys.append(JSONObjectKey(raw: key.raw, escaped: key.escaped, offset: keyOffset))
+                }
+                skipWhitespace()
+                guard index < bytes.count && bytes[index] == UInt8(ascii: ":") else {
+                    throw JSONTranscodingError.invalidJSON(offset: index)
+                }
+                index += 1
+            }
+            try parseValue(into: &sink, depth: depth + 1)
+            count += 1
+            skipWhitespace()
+            guard index < bytes.count else {
+                throw JSONTranscodingError.invalidJSON(offset: index)
+            }
+            if bytes[index] == close {
+                if isMap && checkingKeys {
+                    try checkKeys(from: firstKey)
+                    keys.removeSubrange(firstKey...)
+                }
+                index += 1
+                sink.endContainer(count: count)
+                return
+            }
+            guard bytes[index] == UInt8(ascii: ",") else {
+                throw JSONTranscodingError.invalidJSON(offset: index)
+            }
+            index += 1
+        }
+    }
+
+    /// Throws `duplicateKey` if two of the keys from `first` onwards, which
+    /// are those of one object, are the same once unescaped.
+    private mutating func checkKeys(from first: Int) throws {
+        guard keys.count - first > 1 else {
+            return
+        }
+        for key in first ..< keys.count {
+            keys[key].hash = keys[key].escaped
+                ? JSONTextParser.unescaped(keys[key].raw).withUnsafeBytes { ContentHash.hash($0) }
+                : ContentHash.hash(keys[key].raw)
+        }
+        // Sorting by hash brings equal keys together, in the order they occur.
+        keys[first...].sort { ($0.hash, $0.offset) < ($1.hash, $1.offset) }
+        var duplicate: Int?
+        var start = first
+        while start < keys.count {
+            var end = start + 1
+            while end < keys.count && keys[end].hash == keys[start].hash {
+                end += 1
+            }
+            for earlier in start ..< end {
+                for later in earlier + 1 ..< end where JSONTextParser.key(keys[earlier], equals: keys[later]) {
+                    duplicate = min(duplicate ?? Int.max, keys[later].offset)
+                }
+            }
+            start = end
+        }
+        if let offset = duplicate {
+            throw JSONTranscodingError.duplicateKey(offset: offset)
+        }
+    }
+
+    private static func key(_ key: JSONObjectKey, equals other: JSONObjectKey) -> Bool {
+        guard key.escaped || other.escaped else {
+            return key.raw.count == other.raw.count
+                && (key.raw.count == 0 || memcmp(key.raw.baseAddress!, other.raw.baseAddress!, key.raw.count) == 0)
+        }
+        return unescaped(key.raw) == unescaped(other.raw)
+    }
+
+    /// Returns the UTF-8 content of a string whose escapes have already been
+    /// validated.
+    private static func unescaped(_ raw: UnsafeRawBufferPointer) -> [UInt8] {
+        var result = [UInt8]()
+        result.reserveCapacity(raw.count)
+        var index = 0
+        while index < raw.count {
+            guard raw[index] == UInt8(ascii: "\\") else {
+                result.append(raw[index])
+                index += 1
+                continue
+            }
+            let escape = decodeEscape(raw, at: index)!
+            result.append(contentsOf: UTF8.encode(Unicode.Scalar(escape.scalar)!)!)
+            index += escape.length
+        }
+        return result
+    }
+
+    /// Parses a string, passing it to the sink, and returns its raw content.
+    @discardableResult
+    private mutating func parseString<Sink: JSONTextSink>(
+        into sink: inout Sink
+    ) throws -> (raw: UnsafeRawBufferPointer, escaped: Bool) {
+        index += 1
+        let start = index
+        var count = 0
+        var escaped = false
+        let quote = SIMD16<UInt8>(repeating: UInt8(ascii: "\""))
+        let backslash = SIMD16<UInt8>(repeating: UInt8(ascii: "\\"))
+        let space = SIMD16<UInt8>(repeating: 0x20)
+        while true {
+            // Skip blocks of sixteen bytes that need no attention.
+            while bytes.count - index >= 16 {
+                let block = bytes.unalignedLoad(fromByteOffset: index, as: SIMD16<UInt8>.self)
+                if any((block .== quote) .| (block .== backslash) .| (block .< space)) {
+                    break
+                }
+                index += 16
+                count += 16
+            }
+            guard index < bytes.count else {
+                throw JSONTranscodingError.invalidJSON(offset: index)
+            }
+            let byte = bytes[index]
+            if byte == UInt8(ascii: "\"") {
+                let raw = UnsafeRawBufferPointer(rebasing: bytes[start ..< index])
+                index += 1
+                sink.text(raw, count: count, escaped: escaped)
+                return (raw, escaped)
+            }
+            if byte == UInt8(ascii: "\\") {
+                guard let escape = JSONTextParser.decodeEscape(bytes, at: index) else {
+                    throw JSONTranscodingError.invalidJSON(offset: index)
+                }
+                let scalar = escape.scalar
+                escaped = true
+                count += scalar < 0x80 ? 1 : scalar < 0x800 ? 2 : scalar < 0x10000 ? 3 : 4
+                index += escape.length
+            } else if byte < 0x20 {
+                throw JSONTranscodingError.invalidJSON(offset: index)
+            } else {
+                count += 1
+                index += 1
+            }
+        }
+    }
+
+    /// Decodes the escape sequence at `index`, combining surrogate pairs.
+    ///
+    /// - Returns: The Unicode scalar value and the length of the sequence in
+    ///   bytes, or `nil` if it is invalid.
+    static func decodeEscape(_ bytes: UnsafeRawBufferPointer,
+                             at index: Int) -> (scalar: UInt32, length: Int)? {
+        guard index + 1 < bytes.count else {
+            return nil
+        }
+        switch bytes[index + 1] {
+        case UInt8(ascii: "\""): return (0x22, 2)
+        case UInt8(ascii: "\\"): return (0x5c, 2)
+        case UInt8(ascii: "/"): return (0x2f, 2)
+        case UInt8(ascii: "b"): return (0x08, 2)
+        case UInt8(ascii: "f"): return (0x0c, 2)
+        case UInt8(ascii: "n"): return (0x0a, 2)
+        case UInt8(ascii: "r"): return (0x0d, 2)
+        case UInt8(ascii: "t"): return (0x09, 2)
+        case UInt8(ascii: "u"): break
+        default: return nil
+        }
+        guard let high = hexQuad(bytes, at: index + 2) else {
+            return nil
+        }
+        switch high {
+        case 0xd800 ..< 0xdc00:
+            guard index + 7 < bytes.count,
+                  bytes[index + 6] == UInt8(ascii: "\\"),
+                  bytes[index + 7] == UInt8(ascii: "u"),
+                  let low = hexQuad(bytes, at: index + 8),
+                  (0xdc00 ..< 0xe000).contains(low) else {
+                return nil
+            }
+            return (0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00), 12)
+        case 0xdc00 ..< 0xe000:
+            return nil
+        default:
+            return (high, 6)
+        }
+    }
+
+    private static func hexQuad(_ bytes: UnsafeRawBufferPointer, at index: Int) -> UInt32? {
+        guard index + 4 <= bytes.count else {
+            return nil
+        }
+        var value: UInt32 = 0
+        for byte in bytes[index ..< index + 4] {
+            let digit: UInt8
+            switch byte {
+            case UInt8(ascii: "0") ... UInt8(ascii: "9"): digit = byte - UInt8(ascii: "0")
+            case UInt8(ascii: "a") ... UInt8(ascii: "f"): digit = byte - UInt8(ascii: "a") + 10
+            case UInt8(ascii: "A") ... UInt8(ascii: "F"): digit = byte - UInt8(ascii: "A") + 10
+            default: return nil
+            }
+            value = value << 4 | UInt32(digit)
+        }
+        return value
+    }
+
+    private mutating func parseNumber<Sink: JSONTextSink>(into sink: inout Sink) throws {
+        let start = index
+        let negative = bytes[index] == UInt8(ascii: "-")
+        if negative {
+            index += 1
+        }
+        let digitsStart = index
+        guard index < bytes.count && isDigit(bytes[index]) else {
+            throw JSONTranscodingError.invalidJSON(offset: index)
+        }
+        if bytes[index] == UInt8(ascii: "0") {
+            index += 1
+        } else {
+            skipDigits()
+        }
+        let digitsEnd = index
+        var integral = true
+        if index < bytes.count && bytes[index] == UInt8(ascii: ".") {
+            integral = false
+            index += 1
+            try requireDigits()
+        }
+        if index < bytes.count && (bytes[index] | 0x20) == UInt8(ascii: "e") {
+            integral = false
+            index += 1
+            if index < bytes.count && (bytes[index] == UInt8(ascii: "+") || bytes[index] == UInt8(ascii: "-")) {
+                index += 1
+            }
+            try requireDigits()
+        }
+        if integral, let magnitude = parseUnsigned(digitsStart ..< digitsEnd) {
+            if !negative {
+                sink.unsigned(magnitude)
+                return
+            }
+            if magnitude == 0 {
+                sink.unsigned(0)
+                return
+            }
+            sink.negative(magnitude - 1)
+            return
+        }
+        // Numbers are short enough to be held in a small string without allocation.
+        let text = String(decoding: UnsafeRawBufferPointer(rebasing: bytes[start ..< index]), as: UTF8.self)
+        guard let value = Double(text), value.isFinite else {
+            throw JSONTranscodingError.invalidJSON(offset: start)
+        }
+        sink.double(value)
+    }
+
+    /// Returns the value of a run of decimal digits, or `nil` on overflow.
+    private func parseUnsigned(_ range: Range<Int>) -> UInt64? {
+        var value: UInt64 = 0
+        for byte in bytes[range] {
+            let (shifted, overflowed) = value.multipliedReportingOverflow(by: 10)
+            let (sum, carried) = shifted.addingReportingOverflow(UInt64(byte - UInt8(ascii: "0")))
+            guard !overflowed && !carried else {
+                return nil
+            }
+            value = sum
+        }
+        return value
+    }
+
+    private func isDigit(_ byte: UInt8) -> Bool {
+        return byte >= UInt8(ascii: "0") && byte <= UInt8(ascii: "9")
+    }
+
+    private mutating func skipDigits() {
+        while index < bytes.count && isDigit(bytes[index]) {
+            index += 1
+        }
+    }
+
+    private mutating func requireDigits() throws {
+        guard index < bytes.count && isDigit(bytes[index]) else {
+            throw JSONTranscodingError.invalidJSON(offset: index)
+        }
+        skipDigits()
+    }
+
+    private mutating func expect(_ literal: StaticString) throws {
+        let count = literal.utf8CodeUnitCount
+        guard bytes.count - index >= count,
+              memcmp(bytes.baseAddress! + index, literal.utf8Start, count) == 0 else {
+            throw JSONTranscodingError.invalidJSON(offset: index)
+        }
+        index += count
+    }
+
+    private mutating func skipWhitespace() {
+        while index < bytes.count {
+            switch bytes[index] {
+            case 0x20, 0x09, 0x0a, 0x0d:
+                index += 1
+            default:
+                return
+            }
+        }
+    }
+}
@@ -0,0 +1,368 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Errors raised when parsing a JSON Pointer.
+ */
+public enum JSONPointerError: Error, Equatable {
+    /// The pointer is not a valid RFC 6901 JSON Pointer.
+    case invalidPointer(String)
+}
+
+/**
+ A lazily indexed, read-only view of a `PTDiffusionJSON` value that returns
+ the values at JSON Pointers (RFC 6901), such as `/prices/3/bid`, without
+ decoding the rest of the value.
+
+ Nothing is indexed until the first access. Resolving a pointer indexes only
+ the maps and arrays along its path, recording the offset of each of their
+ items and skipping over the items' encoded bytes without decoding them.
+ These container indexes and the offsets of resolved pointers are cached, so
+ later accesses to the same or nearby values cost a few dictionary lookups.
+
+ A view is not thread safe.
+ */
+public final class LazyJSONView {
+    private enum ContainerIndex {
+        case map([String: Int])
+        case array([Int])
+        case scalar
+    }
+
+    /// The value being viewed.
+    public let json: PTDiffusionJSON
+
+    private let data: Data
+    private let keys: CBORStringTable
+    private var containers = [Int: ContainerIndex]()
+    private var pointers = [String: Int]()
+
+    /**
+     Creates a view of a JSON value.
+
+     - Parameter keys: A table used to intern map keys. Sharing a table
+       between the views of successive values of a topic avoids allocating
+       the same key strings for every value.
+     */
+    public init(_ json: PTDiffusionJSON, keys: CBORStringTable = CBORStringTable()) {
+        self.json = json
+        self.data = json.data
+        self.keys = keys
+    }
+
+    // MARK: Resolving pointers
+
+    /**
+     Returns the offset within the CBOR data of the item at the pointer.
+
+     - Returns: The offset, or `nil` if there is no value at the pointer.
+
+     - Throws: `JSONPointerError` if the pointer is invalid, or `CBORError`
+       if the CBOR along the pointer's path is malformed.
+     */
+    public func offset(at pointer: String) throws -> Int? {
+        if let offset = pointers[pointer] {
+            return offset
+        }
+        let tokens = try LazyJSONView.referenceTokens(pointer)
+        let resolved: Int? = try data.withUnsafeBytes { buffer in
+            var offset = 0
+            for token in tokens {
+                guard let child = try child(of: offset, token: token, in: buffer) else {
+                    return nil
+                }
+                offset = child
+            }
+            return offset
+        }
+        if let offset = resolved {
+            pointers[pointer] = offset
+        }
+        return resolved
+    }
+
+    /// Returns `true` if there is a value at the pointer.
+    public func contains(_ pointer: String) throws -> Bool {
+        return try offset(at: pointer) != nil
+    }
+
+    // MARK: Typed access
+
+    /// Returns the string at the pointer, or `nil` if there is no value at
+    /// the pointer or it is not a definite length text string.
+    public func string(at pointer: String) throws -> String? {
+        return try read(pointer) { reader, token in
+            guard case .text(let range) = token else {
+                return nil
+            }
+            // Values are not interned, as they would fill the key table.
+            return try reader.validatedString(range)
+        }
+    }
+
+    /// Returns the integer at the pointer, or `nil` if there is no value at
+    /// the pointer or it is not an integer that fits in an `Int64`.
+    public func integer(at pointer: String) throws -> Int64? {
+        return try read(pointer) { _, token in
+            switch token {
+            case .unsigned(let value):
+                return Int64(exactly: value)
+            case .negative(let argument):
+                return argument <= UInt64(Int64.max) ? -1 - Int64(argument) : nil
+            default:
+                return nil
+            }
+        }
+    }
+
+    /// Returns the number at the pointer, or `nil` if there is no value at
+    /// the pointer or it is not a number.
+    public func double(at pointer: String) throws -> Double? {
+        return try read(pointer) { _, token in
+            switch token {
+            case .float(let value):
+                return value
+            case .unsigned(let value):
+                return Double(value)
+            case .negative(let argument):
+                return -1 - Double(argument)
+            default:
+                return nil
+            }
+        }
+    }
+
+    /// Returns the boolean at the pointer, or `nil` if there is no value at
+    /// the pointer or it is not a boolean.
+    public func bool(at pointer: String) throws -> Bool? {
+        return try read(pointer) { _, token in
+            guard case .bool(let value) = token else {
+                return nil
+            }
+            return value
+        }
+    }
+
+    /// Returns `true` if the value at the pointer is null.
+    public func isNull(at pointer: String) throws -> Bool {
+        return try read(pointer) { _, token in
+            guard case .null = token else {
+                return nil
+            }
+            return true
+        } ?? false
+    }
+
+    /// Returns the number of items in the array, or of entries with text
+    /// keys in the map, at the pointer, or `nil` if there is no value at the
+    /// pointer or it is not an array or map.
+    public func count(at pointer: String) throws -> Int? {
+        guard let offset = try offset(at: pointer) else {
+            return nil
+        }
+        return try data.withUnsafeBytes { buffer -> Int? in
+            switch try index(of: offset, in: buffer) {
+            case .map(let entries):
+                return entries.count
+            case .array(let elements):
+                return elements.count
+            case .scalar:
+                return nil
+            }
+        }
+    }
+
+    /**
+     Returns the value at the pointer decoded as the given type, decoding
+     only that value.
+
+     - Returns: The value, or `nil` if there is no value at the pointer.
+     */
+    public func decode<T: Decodable>(_ type: T.Type,
+                                     at pointer: String,
+                                     decoder: DiffusionCBORDecoder = DiffusionCBORDecoder()) throws -> T? {
+        guard let offset = try offset(at: pointer) else {
+            return nil
+        }
+        return try data.withUnsafeBytes { buffer in
+            try decoder.decode(type, in: buffer, at: offset)
+        }
+    }
+
+    /// Returns the value at the pointer as a separate JSON value, or `nil`
+    /// if there is no value at the pointer. The item's bytes are copied but
+    /// not decoded.
+    public func json(at pointer: String) throws -> PTDiffusionJSON? {
+        guard let offset = try offset(at: pointer) else {
+            return nil
+        }
+        let end: Int = try data.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer, offset: offset)
+            try reader.skipItem()
+            return reader.offset
+        }
+        return PTDiffusionJSON(data: data.subdata(in: offset ..< end))
+    }
+
+    // MARK: Indexing
+
+    private func read<T>(_ pointer: String,
+                         _ body: (CBORReader, CBORToken) throws -> T?) throws -> T? {
+        guard let offset = try offset(at: pointer) else {
+            return nil
+        }
+        return try data.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer, offset: offset)
+            let token = try LazyJSONView.untaggedToken(&reader)
+            return try body(reader, token)
+        }
+    }
+
+    private func child(of offset: Int, token: String, in buffer: UnsafeRawBufferPointer) throws -> Int? {
+        switch try index(of: offset, in: buffer) {
+        case .map(let entries):
+            return entries[token]
+        case .array(let elements):
+            guard let index = LazyJSONView.arrayIndex(token), index < elements.count else {
+                return nil
+            }
+            return elements[index]
+        case .scalar:
+            return nil
+        }
+    }
+
+    private func index(of offset: Int, in buffer: UnsafeRawBufferPointer) throws -> ContainerIndex {
+        if let index = containers[offset] {
+            return index
+        }
+        var reader = CBORReader(buffer, offset: offset)
+        let index: ContainerIndex
+        switch try LazyJSONView.untaggedToken(&reader) {
+        case .map(let count):
+            var entries = [String: Int]()
+            var item = 0
+            while reader.hasItem(count: count, index: item) {
+                // Keys may be of any type, so skip the whole key before
+                // noting where its value starts.
+                let keyOffset = reader.offset
+                try reader.skipItem()
+                let valueOffset = reader.offset
+                try reader.skipItem()
+                if let key = try key(at: keyOffset, in: buffer) {
+                    entries[key] = valueOffset
+                }
+                item += 1
+            }
+            index = .map(entries)
+        case .array(let count):
+            var elements = [Int]()
+            if let count = count {
+                elements.reserveCapacity(count)
+            }
+            while reader.hasItem(count: count, index: elements.count) {
+                elements.append(reader.offset)
+                try reader.skipItem()
+            }
+            index = .array(elements)
+        default:
+            index = .scalar
+        }
+        containers[offset] = index
+        return index
+    }
+
+    /// Returns the map key at `offset`, or `nil` if it is not a text string
+    /// and so cannot be addressed by a pointer.
+    private func key(at offset: Int, in buffer: UnsafeRawBufferPointer) throws -> String? {
+        var reader = CBORReader(buffer, offset: offset)
+        switch try LazyJSONView.untaggedToken(&reader) {
+        case .text(let range):
+            return try reader.validatedString(range, interning: keys)
+        case .indefiniteText:
+            // Each chunk is a definite length text string of whole characters.
+            // Chunked keys are rare, so the joined key is not interned.
+            var key = ""
+            while !reader.consumeBreak() {
+                let chunk = reader.offset
+                guard case .text(let range) = try reader.next() else {
+                    throw CBORError.malformed(offset: chunk)
+                }
+                key += try reader.validatedString(range)
+            }
+            return key
+        default:
+            return nil
+        }
+    }
+
+    private static func untaggedToken(_ reader: inout CBORReader) throws -> CBORToken {
+        var token = try reader.next()
+        while case .tag = token {
+            token = try reader.next()
+        }
+        return token
+    }
+
+    // MARK: JSON Pointer syntax
+
+    /// Splits a pointer into its unescaped reference tokens.
+    static func referenceTokens(_ pointer: String) throws -> [String] {
+        guard !pointer.isEmpty else {
+            return []
+        }
+        guard pointer.hasPrefix("/") else {
+            throw JSONPointerError.invalidPointer(pointer)
+        }
+        return try pointer.dropFirst().split(separator: "/", omittingEmptySubsequences: false).map { token in
+            guard token.contains("~") else {
+                return String(token)
+            }
+            var result = ""
+            var escaping = false
+            for character in token {
+                if escaping {
+                    switch character {
+                    case "0": result.append("~")
+                    case "1": result.append("/")
+                    default: throw JSONPointerError.invalidPointer(pointer)
+                    }
+                    escaping = false
+                } else if character == "~" {
+                    escaping = true
+                } else {
+                    result.append(character)
+                }
+            }
+            guard !escaping else {
+                throw JSONPointerError.invalidPointer(pointer)
+            }
+            return result
+        }
+    }
+
+    /// Returns the array index for a reference token, which must be `0` or a
+    /// decimal number without leading zeros.
+    static func arrayIndex(_ token: String) -> Int? {
+        let utf8 = token.utf8
+        guard let first = utf8.first,
+              utf8.allSatisfy({ $0 >= UInt8(ascii: "0") && $0 <= UInt8(ascii: "9") }),
+              first != UInt8(ascii: "0") || utf8.count == 1 else {
+            return nil
+        }
+        return Int(token)
+    }
+}
+
+extension PTDiffusionJSON {
+    /// Returns a lazily indexed view of the receiver's value.
+    public func lazyView(keys: CBORStringTable = CBORStringTable()) -> LazyJSONView {
+        return LazyJSONView(self, keys: keys)
+    }
+}
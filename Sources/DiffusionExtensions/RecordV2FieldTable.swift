@@ -0,0 +1,239 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/// Control bytes of the RecordV2 data format.
+enum RecordV2Format {
+    static let recordDelimiter: UInt8 = 0x01
+    static let fieldDelimiter: UInt8 = 0x02
+    /// Stands for a field whose value is the empty string.
+    static let emptyField: UInt8 = 0x03
+}
+
+/**
+ The fields of a RecordV2 value, located in a single pass over its bytes.
+
+ The table records where each field's bytes start and end, without creating
+ a string per field as `recordsWithError:` does. Values are read from the
+ bytes on demand, by position or by a `RecordV2Slot` from a `RecordV2Plan`,
+ and integers and decimals are parsed in place.
+
+ A table can be reloaded with successive values of a topic, reusing its
+ storage.
+ */
+public struct RecordV2FieldTable {
+    /// The bytes of the value.
+    public private(set) var data = Data()
+
+    private var fields = [Range<Int>]()
+    // The index in fields of each record's first field, followed by the
+    // number of fields.
+    private var recordStarts = [0]
+
+    public init() {
+    }
+
+    public init(_ data: Data) {
+        reload(data)
+    }
+
+    public init(_ record: PTDiffusionRecordV2) {
+        reload(record.data)
+    }
+
+    /// Replaces the table's contents with the fields of the given value.
+    public mutating func reload(_ data: Data) {
+        self.data = data
+        fields.removeAll(keepingCapacity: true)
+        recordStarts.removeAll(keepingCapacity: true)
+        recordStarts.append(0)
+        guard !data.isEmpty else {
+            return
+        }
+        data.withUnsafeBytes { buffer in
+            var recordStart = 0
+            var fieldStart = 0
+            var index = 0
+            while true {
+                index = RecordV2FieldTable.nextDelimiter(in: buffer, from: index)
+                if index < buffer.count && buffer[index] == RecordV2Format.fieldDelimiter {
+                    fields.append(fieldStart ..< index)
+                } else {
+                    // A record with no bytes has no fields.
+                    if index > recordStart {
+                        fields.append(fieldStart ..< index)
+                    }
+                    recordStarts.append(fields.count)
+                    recordStart = index + 1
+                    if index == buffer.count {
+                        break
+                    }
+                }
+                index += 1
+                fieldStart = index
+            }
+        }
+    }
+
+    /// The number of records in the value.
+    public var recordCount: Int {
+        return recordStarts.count - 1
+    }
+
+    /// Returns the number of fields in a record.
+    public func fieldCount(inRecord record: Int) -> Int {
+        precondition(record >= 0 && record < recordCount, "Record index out of range")
+        return recordStarts[record + 1] - recordStarts[record]
+    }
+
+    /// Returns the range of the value's bytes that holds a field, or `nil` if
+    /// the value has no such field. The range of an empty field is empty.
+    public func range(record: Int, field: Int) -> Range<Int>? {
+        guard record >= 0 && record < recordCount && field >= 0 else {
+            return nil
+        }
+        let index = recordStarts[record] + field
+        guard index < recordStarts[record + 1] else {
+            return nil
+        }
+        let range = fields[index]
+        if range.count == 1 && data[data.startIndex + range.lowerBound] == RecordV2Format.emptyField {
+            return range.lowerBound ..< range.lowerBound
+        }
+        return range
+    }
+
+    /// Returns the range of the value's bytes that holds the field at a slot.
+    public func range(at slot: RecordV2Slot) -> Range<Int>? {
+        return range(record: slot.record, field: slot.field)
+    }
+
+    /// Returns the field at a slot as a string, or `nil` if the value has no
+    /// such field.
+    public func string(at slot: RecordV2Slot) -> String? {
+        return withField(slot) { String(decoding: $0, as: UTF8.self) }
+    }
+
+    /// Returns the field at a slot as an integer, or `nil` if the value has
+    /// no such field or it is not an integer that fits in an `Int64`.
+    public func integer(at slot: RecordV2Slot) -> Int64? {
+        return withField(slot) { RecordV2FieldTable.parse($0, scale: 0) } ?? nil
+    }
+
+    /**
+     Returns the decimal field at a slot as an integer count of units of its
+     scale, so that `12.34` in a field with a scale of 2 is `1234`.
+
+     - Returns: The scaled value, or `nil` if the value has no such field or
+       it is not a decimal with at most `slot.scale` fractional digits that
+       fits in an `Int64` when scaled.
+     */
+    public func scaledDecimal(at slot: RecordV2Slot) -> Int64? {
+        return withField(slot) { RecordV2FieldTable.parse($0, scale: slot.scale) } ?? nil
+    }
+
+    /// Returns the decimal field at a slot, or `nil` if the value has no such
+    /// field or it is not a decimal that `scaledDecimal(at:)` can parse.
+    public func decimal(at slot: RecordV2Slot) -> Decimal? {
+        guard let scaled = scaledDecimal(at: slot) else {
+            return nil
+        }
+        return Decimal(sign: scaled < 0 ? .minus : .plus,
+                       exponent: -slot.scale,
+                       significand: Decimal(scaled.magnitude))
+    }
+
+    /// Calls a closure with the bytes of the field at a slot.
+    public func withField<Result>(_ slot: RecordV2Slot,
+                                  _ body: (UnsafeRawBufferPointer) throws -> Result) rethrows -> Result? {
+        guard let range = range(at: slot) else {
+            return nil
+        }
+        return try data.withUnsafeBytes { buffer in
+            try body(UnsafeRawBufferPointer(rebasing: buffer[range]))
+        }
+    }
+
+    // MARK: Parsing
+
+    /// Returns the index of the next record or field delimiter at or after
+    /// `index`, or the end of the buffer.
+    private static func nextDelimiter(in buffer: UnsafeRawBufferPointer, from index: Int) -> Int {
+        var index = index
+        // Field text rarely contains control bytes, so skip sixteen bytes at
+        // a time while none is at or below the field delimiter.
+        let limit = SIMD16<UInt8>(repeating: RecordV2Format.fieldDelimiter)
+        while index + 16 <= buffer.count {
+            let block = buffer.unalignedLoad(fromByteOffset: index, as: SIMD16<UInt8>.self)
+            if any(block .<= limit) {
+                break
+            }
+            index += 16
+        }
+        while index < buffer.count {
+            let byte = buffer[index]
+            if byte == RecordV2Format.recordDelimiter || byte == RecordV2Format.fieldDelimiter {
+                return index
+            }
+            index += 1
+        }
+        return index
+    }
+
+    /// Parses an optionally signed decimal number with at most `scale`
+    /// fractional digits into an integer count of units of that scale.
+    static func parse(_ bytes: UnsafeRawBufferPointer, scale: Int) -> Int64? {
+        var index = 0
+        let negative = bytes.first == UInt8(ascii: "-")
+        if negative {
+            index += 1
+        }
+        var magnitude: UInt64 = 0
+        var digits = 0
+        var fractionDigits: Int?
+        while index < bytes.count {
+            let byte = bytes[index]
+            index += 1
+            if byte == UInt8(ascii: ".") && fractionDigits == nil && scale > 0 {
+                fractionDigits = 0
+                continue
+            }
+            guard byte >= UInt8(ascii: "0") && byte <= UInt8(ascii: "9"),
+                  let shifted = multiply(magnitude, 10, adding: UInt64(byte - UInt8(ascii: "0"))) else {
+                return nil
+            }
+            magnitude = shifted
+            digits += 1
+            if let count = fractionDigits {
+                guard count < scale else {
+                    return nil
+                }
+                fractionDigits = count + 1
+            }
+        }
+        guard digits > 0 else {
+            return nil
+        }
+        for _ in (fractionDigits ?? 0) ..< scale {
+            guard let shifted = multiply(magnitude, 10, adding: 0) else {
+                return nil
+            }
+            magnitude = shifted
+        }
+        if negative {
+            return magnitude <= UInt64(Int64.max) + 1 ? Int64(truncatingIfNeeded: 0 &- magnitude) : nil
+        }
+        return Int64(exactly: magnitude)
+    }
+
+    private static func multiply(_ value: UInt64, _ factor: UInt64, adding addend: UInt64) -> UInt64? {
+        let (product, overflow) = value.multipliedReportingOverflow(by: factor)
+        let (sum, carry) = product.addingReportingOverflow(addend)
+        return overflow || carry ? nil : sum
+    }
+}
@@ -0,0 +1,126 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ The position of one field occurrence within a RecordV2 value, resolved by a
+ `RecordV2Plan`.
+ */
+public struct RecordV2Slot: Hashable {
+    /// The index of the record within the value.
+    public let record: Int
+
+    /// The index of the field within its record.
+    public let field: Int
+
+    /// The number of digits after the decimal point for a decimal field, or
+    /// zero for other fields.
+    public let scale: Int
+
+    public init(record: Int, field: Int, scale: Int = 0) {
+        self.record = record
+        self.field = field
+        self.scale = scale
+    }
+
+    /**
+     Returns the slot of the same field a number of records or fields on.
+
+     Use this to step through the occurrences of a repeating record or field
+     from the slot of its first occurrence, resolving names only once. The
+     result is not checked against the schema's multiplicities.
+     */
+    public func advanced(byRecords records: Int, fields: Int = 0) -> RecordV2Slot {
+        return RecordV2Slot(record: record + records, field: field + fields, scale: scale)
+    }
+}
+
+/**
+ A `PTDiffusionRecordV2Schema` compiled to the positions of its records and
+ fields.
+
+ Only the last record of a schema and the last field of a record may have
+ variable multiplicity, so every other record and field occurs at a fixed
+ position. The plan computes these positions once, and `slot(record:...)`
+ maps a field name and occurrence to a `RecordV2Slot` that indexes a
+ `RecordV2FieldTable` directly, instead of looking names up for every value
+ as `fieldValueForRecordName:recordIndex:fieldName:fieldIndex:error:` does.
+
+ A plan is immutable and may be shared between threads.
+ */
+public final class RecordV2Plan {
+    private struct FieldPlan {
+        let start: Int
+        let max: Int?
+        let scale: Int
+    }
+
+    private struct RecordPlan {
+        let start: Int
+        let max: Int?
+        let fields: [String: FieldPlan]
+    }
+
+    private let records: [String: RecordPlan]
+
+    /// Compiles a schema.
+    public init(schema: PTDiffusionRecordV2Schema) {
+        var records = [String: RecordPlan]()
+        var recordStart = 0
+        for record in schema.records {
+            var fields = [String: FieldPlan]()
+            var fieldStart = 0
+            for field in record.fields {
+                let max = RecordV2Plan.maximum(field.max)
+                fields[field.name] = FieldPlan(start: fieldStart, max: max, scale: Int(field.scale))
+                // An unlimited field is always the last in its record.
+                fieldStart += max ?? 0
+            }
+            let max = RecordV2Plan.maximum(record.max)
+            records[record.name] = RecordPlan(start: recordStart, max: max, fields: fields)
+            recordStart += max ?? 0
+        }
+        self.records = records
+    }
+
+    /**
+     Returns the slot of an occurrence of a field.
+
+     - Returns: The slot, or `nil` if the schema has no such record or field,
+       or an index exceeds the multiplicity of its record or field.
+     */
+    public func slot(record: String,
+                     recordIndex: Int = 0,
+                     field: String,
+                     fieldIndex: Int = 0) -> RecordV2Slot? {
+        guard let recordPlan = records[record],
+              let fieldPlan = recordPlan.fields[field],
+              RecordV2Plan.index(recordIndex, isWithin: recordPlan.max),
+              RecordV2Plan.index(fieldIndex, isWithin: fieldPlan.max) else {
+            return nil
+        }
+        return RecordV2Slot(record: recordPlan.start + recordIndex,
+                            field: fieldPlan.start + fieldIndex,
+                            scale: fieldPlan.scale)
+    }
+
+    private static func maximum(_ max: Int32) -> Int? {
+        return max < 0 ? nil : Int(max)
+    }
+
+    private static func index(_ index: Int, isWithin max: Int?) -> Bool {
+        return index >= 0 && index < (max ?? Int.max)
+    }
+}
+
+extension PTDiffusionRecordV2Schema {
+    /// Returns the receiver compiled to a plan of record and field positions.
+    public func compiledPlan() -> RecordV2Plan {
+        return RecordV2Plan(schema: self)
+    }
+}
@@ -0,0 +1,109 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+import Diffusion
+
+/**
+ Writes RecordV2 values directly from typed field values.
+
+ Integers and decimals are formatted straight into the value's bytes rather
+ than through intermediate strings, so a writer that is cleared and reused
+ for each update does not allocate per field. Fields are written in schema
+ order; a `RecordV2Plan` can be used to check their positions.
+
+ String fields must not contain the RecordV2 control bytes `0x01`, `0x02` or
+ `0x03`, as with `PTDiffusionRecordV2Builder`.
+ */
+public struct RecordV2Writer {
+    private var bytes: [UInt8]
+    private var hasRecord = false
+    private var fieldsInRecord = 0
+
+    public init(capacity: Int = 256) {
+        bytes = []
+        bytes.reserveCapacity(capacity)
+    }
+
+    /// Starts a new record. Fields written before the first call to this
+    /// method start a record implicitly.
+    public mutating func beginRecord() {
+        if hasRecord {
+            bytes.append(RecordV2Format.recordDelimiter)
+        }
+        hasRecord = true
+        fieldsInRecord = 0
+    }
+
+    /// Appends a string field to the current record.
+    public mutating func append(_ string: String) {
+        beginField()
+        if string.isEmpty {
+            bytes.append(RecordV2Format.emptyField)
+        } else {
+            bytes.append(contentsOf: string.utf8)
+        }
+    }
+
+    /// Appends an integer field to the current record.
+    public mutating func append(_ integer: Int64) {
+        beginField()
+        appendDigits(of: integer, scale: 0)
+    }
+
+    /**
+     Appends a decimal field to the current record, given as an integer
+     count of units of its scale. The field is written with exactly `scale`
+     fractional digits, so `append(scaledDecimal: 1250, scale: 3)` writes
+     `1.250`.
+     */
+    public mutating func append(scaledDecimal: Int64, scale: Int) {
+        precondition(scale >= 0, "Scale must not be negative")
+        beginField()
+        appendDigits(of: scaledDecimal, scale: scale)
+    }
+
+    /// Returns the value written so far.
+    public func record() -> PTDiffusionRecordV2 {
+        return PTDiffusionRecordV2(data: Data(bytes))
+    }
+
+    /// Discards all records, keeping the writer's storage for reuse.
+    public mutating func removeAll() {
+        bytes.removeAll(keepingCapacity: true)
+        hasRecord = false
+        fieldsInRecord = 0
+    }
+
+    private mutating func beginField() {
+        if !hasRecord {
+            beginRecord()
+        }
+        if fieldsInRecord > 0 {
+            bytes.append(RecordV2Format.fieldDelimiter)
+        }
+        fieldsInRecord += 1
+    }
+
+    private mutating func appendDigits(of value: Int64, scale: Int) {
+        if value < 0 {
+            bytes.append(UInt8(ascii: "-"))
+        }
+        // Writes the digits in reverse, then reverses them in place.
+        let start = bytes.count
+        var magnitude = value.magnitude
+        var written = 0
+        while magnitude > 0 || written <= scale {
+            if written == scale && scale > 0 {
+                bytes.append(UInt8(ascii: "."))
+            }
+            bytes.append(UInt8(ascii: "0") + UInt8(magnitude % 10))
+            magnitude /= 10
+            written += 1
+        }
+        bytes[start...].reverse()
+    }
+}
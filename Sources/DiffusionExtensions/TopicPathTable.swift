@@ -0,0 +1,150 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+
+/**
+ A compact handle for a topic path interned in a `TopicPathTable`.
+
+ Handles are only meaningful to the table that issued them.
+ */
+public struct TopicPath: Hashable {
+    let index: UInt32
+}
+
+/**
+ Stores topic paths once each, sharing the segments and prefixes that paths
+ have in common.
+
+ A path is held as a node in a tree of path segments, each node recording its
+ parent and the index of its last segment, so `a/b/c` and `a/b/d` share the
+ nodes for `a` and `a/b` and every distinct segment string is stored once.
+ Applications that keep state for many subscribed topics can key it on the
+ 4-byte `TopicPath` handle instead of retaining a path string per topic, and
+ intern the path passed to each value stream callback to find the same
+ handle every time.
+
+ Path strings are rebuilt on demand by `path(for:)`. Paths are split at `/`
+ and empty segments are preserved, so every path round trips exactly.
+
+ A table is not thread safe. Use one per delegate queue.
+ */
+public final class TopicPathTable {
+    /// The handle for the empty path.
+    public static let root = TopicPath(index: 0)
+
+    private var parents: [UInt32] = [0]
+    private var nodeSegments: [UInt32] = [0]
+    private var children = [UInt64: UInt32]()
+    private var segments: [String] = []
+    private var segmentIndexes = [String: UInt32]()
+
+    public init() {
+    }
+
+    /// The number of distinct paths, including each prefix of an interned
+    /// path, held by the table.
+    public var count: Int {
+        return parents.count - 1
+    }
+
+    /// The number of distinct path segments held by the table.
+    public var segmentCount: Int {
+        return segments.count
+    }
+
+    /// Returns the handle for a path, adding the path to the table if it is
+    /// not already present.
+    public func intern(_ path: String) -> TopicPath {
+        guard !path.isEmpty else {
+            return TopicPathTable.root
+        }
+        var node: UInt32 = 0
+        for segment in path.split(separator: "/", omittingEmptySubsequences: false) {
+            let segmentIndex = index(ofSegment: segment)
+            let key = TopicPathTable.childKey(node, segmentIndex)
+            if let child = children[key] {
+                node = child
+            } else {
+                let child = UInt32(parents.count)
+                parents.append(node)
+                nodeSegments.append(segmentIndex)
+                children[key] = child
+                node = child
+            }
+        }
+        return TopicPath(index: node)
+    }
+
+    /// Returns the handle for a path, or `nil` if the path has not been
+    /// interned. The table is not modified.
+    public func existing(_ path: String) -> TopicPath? {
+        guard !path.isEmpty else {
+            return TopicPathTable.root
+        }
+        var node: UInt32 = 0
+        for segment in path.split(separator: "/", omittingEmptySubsequences: false) {
+            guard let segmentIndex = segmentIndexes[String(segment)],
+                  let child = children[TopicPathTable.childKey(node, segmentIndex)] else {
+                return nil
+            }
+            node = child
+        }
+        return TopicPath(index: node)
+    }
+
+    /// Returns the path for a handle issued by this table.
+    public func path(for handle: TopicPath) -> String {
+        var segmentsOfPath = [Substring]()
+        var node = handle.index
+        while node != 0 {
+            segmentsOfPath.append(Substring(segments[Int(nodeSegments[Int(node)])]))
+            node = parents[Int(node)]
+        }
+        return segmentsOfPath.reversed().joined(separator: "/")
+    }
+
+    /// Returns the handle for the path without its last segment, or `nil` for
+    /// the empty path.
+    public func parent(of handle: TopicPath) -> TopicPath? {
+        guard handle.index != 0 else {
+            return nil
+        }
+        return TopicPath(index: parents[Int(handle.index)])
+    }
+
+    /// Returns the last segment of a path, or `nil` for the empty path.
+    public func lastSegment(of handle: TopicPath) -> String? {
+        guard handle.index != 0 else {
+            return nil
+        }
+        return segments[Int(nodeSegments[Int(handle.index)])]
+    }
+
+    /// Discards all paths. Handles issued before this call must not be used.
+    public func removeAll() {
+        parents = [0]
+        nodeSegments = [0]
+        children.removeAll()
+        segments.removeAll()
+        segmentIndexes.removeAll()
+    }
+
+    private func index(ofSegment segment: Substring) -> UInt32 {
+        let string = String(segment)
+        if let index = segmentIndexes[string] {
+            return index
+        }
+        let index = UInt32(segments.count)
+        segments.append(string)
+        segmentIndexes[string] = index
+        return index
+    }
+
+    private static func childKey(_ parent: UInt32, _ segment: UInt32) -> UInt64 {
+        return UInt64(parent) << 32 | UInt64(segment)
+    }
+}
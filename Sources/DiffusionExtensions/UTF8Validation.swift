@@ -0,0 +1,84 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+/**
+ Strict UTF-8 validation with a vectorised ASCII fast path.
+
+ Runs of ASCII are skipped sixteen bytes at a time using the portable SIMD
+ types, which lower to NEON or SSE. Multi-byte sequences are checked one at a
+ time, rejecting overlong encodings, surrogates and code points above U+10FFFF.
+
+ This is for text that is checked without being made into a `String`, such
+ as the input and output of `JSONTranscoder`. Text that is materialised is
+ validated by the standard library as the string is built; see
+ `CBORReader.validatedString(_:interning:)`.
+ */
+enum UTF8Validation {
+    /// Returns the offset of the first byte that does not begin a valid
+    /// sequence, or `nil` if the whole buffer is valid UTF-8.
+    static func firstInvalidOffset(in buffer: UnsafeRawBufferPointer) -> Int? {
+        var index = 0
+        while true {
+            index = asciiPrefixEnd(buffer, from: index)
+            if index == buffer.count {
+                return nil
+            }
+            guard let length = sequenceLength(buffer, at: index) else {
+                return index
+            }
+            index += length
+        }
+    }
+
+    static func isASCII(_ buffer: UnsafeRawBufferPointer) -> Bool {
+        return asciiPrefixEnd(buffer, from: 0) == buffer.count
+    }
+
+    /// Returns the offset of the first non-ASCII byte at or after `start`, or
+    /// the buffer's count if there is none.
+    static func asciiPrefixEnd(_ buffer: UnsafeRawBufferPointer, from start: Int) -> Int {
+        let highBit = SIMD16<UInt8>(repeating: 0x80)
+        var index = start
+        while buffer.count - index >= 16 {
+            let block = buffer.unalignedLoad(fromByteOffset: index, as: SIMD16<UInt8>.self)
+            if any(block .>= highBit) {
+                break
+            }
+            index += 16
+        }
+        while index < buffer.count && buffer[index] < 0x80 {
+            index += 1
+        }
+        return index
+    }
+
+    /// Returns the length of the multi-byte sequence at `index`, or `nil` if
+    /// it is invalid or truncated.
+    private static func sequenceLength(_ buffer: UnsafeRawBufferPointer, at index: Int) -> Int? {
+        let remaining = buffer.count - index
+        func byte(_ offset: Int, in range: ClosedRange<UInt8> = 0x80 ... 0xbf) -> Bool {
+            return offset < remaining && range.contains(buffer[index + offset])
+        }
+        switch buffer[index] {
+        case 0xc2 ... 0xdf:
+            return byte(1) ? 2 : nil
+        case 0xe0:
+            return byte(1, in: 0xa0 ... 0xbf) && byte(2) ? 3 : nil
+        case 0xe1 ... 0xec, 0xee ... 0xef:
+            return byte(1) && byte(2) ? 3 : nil
+        case 0xed:
+            return byte(1, in: 0x80 ... 0x9f) && byte(2) ? 3 : nil
+        case 0xf0:
+            return byte(1, in: 0x90 ... 0xbf) && byte(2) && byte(3) ? 4 : nil
+        case 0xf1 ... 0xf3:
+            return byte(1) && byte(2) && byte(3) ? 4 : nil
+        case 0xf4:
+            return byte(1, in: 0x80 ... 0x8f) && byte(2) && byte(3) ? 4 : nil
+        default:
+            return nil
+        }
+    }
+}
@@ -0,0 +1,30 @@
+//  Diffusion Client Library for iOS, tvOS and OS X / macOS
+//
+//  Copyright (c) 2026 DiffusionData Ltd., All Rights Reserved.
+//
+//  Use is subject to licence terms.
+
+import Foundation
+
+// Loads from byte offsets with no alignment requirement. The standard
+// library's loadUnaligned(fromByteOffset:as:) needs Swift 5.7, later than
+// the package's tools version; a fixed-size memcpy compiles to the same
+// single unaligned load.
+
+extension UnsafeRawBufferPointer {
+    @inline(__always)
+    func unalignedLoad<T: FixedWidthInteger>(fromByteOffset offset: Int, as type: T.Type) -> T {
+        precondition(offset >= 0 && offset + MemoryLayout<T>.size <= count, "Load out of bounds")
+        var value = T.zero
+        memcpy(&value, baseAddress! + offset, MemoryLayout<T>.size)
+        return value
+    }
+
+    @inline(__always)
+    func unalignedLoad<T: SIMD>(fromByteOffset offset: Int, as type: T.Type) -> T {
+        precondition(offset >= 0 && offset + MemoryLayout<T>.size <= count, "Load out of bounds")
+        var value = T()
+        memcpy(&value, baseAddress! + offset, MemoryLayout<T>.size)
+        return value
+    }
+}
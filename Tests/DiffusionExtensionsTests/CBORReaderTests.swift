@@ -0,0 +1,161 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class CBORReaderTests: XCTestCase {
+    private func tokens(_ bytes: [UInt8]) throws -> [CBORToken] {
+        return try bytes.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            var result = [CBORToken]()
+            while !reader.isAtEnd {
+                result.append(try reader.next())
+            }
+            return result
+        }
+    }
+
+    func testIntegers() throws {
+        XCTAssertEqual(try tokens([0x00, 0x17, 0x18, 0x18, 0x19, 0x03, 0xe8]),
+                       [.unsigned(0), .unsigned(23), .unsigned(24), .unsigned(1000)])
+        XCTAssertEqual(try tokens([0x20, 0x38, 0x63]), [.negative(0), .negative(99)])
+        XCTAssertEqual(try tokens([0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff]),
+                       [.unsigned(UInt64.max)])
+    }
+
+    func testSimpleValuesAndFloats() throws {
+        XCTAssertEqual(try tokens([0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xff]),
+                       [.bool(false), .bool(true), .null, .undefined, .simple(255)])
+        XCTAssertEqual(try tokens([0xf9, 0x3c, 0x00]), [.float(1.0)])
+        XCTAssertEqual(try tokens([0xf9, 0x00, 0x01]), [.float(5.960464477539063e-8)])
+        XCTAssertEqual(try tokens([0xf9, 0xfc, 0x00]), [.float(-.infinity)])
+        XCTAssertEqual(try tokens([0xfa, 0x47, 0xc3, 0x50, 0x00]), [.float(100000.0)])
+        XCTAssertEqual(try tokens([0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a]),
+                       [.float(1.1)])
+    }
+
+    func testStringsAreSlicesOfTheBuffer() throws {
+        let bytes: [UInt8] = [0x62, 0x68, 0x69, 0x42, 0x01, 0x02]
+        try bytes.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            guard case .text(let text) = try reader.next() else {
+                return XCTFail()
+            }
+            XCTAssertEqual(text, 1 ..< 3)
+            XCTAssertTrue(reader.text(text, equals: "hi"))
+            XCTAssertFalse(reader.text(text, equals: "ho"))
+            XCTAssertEqual(reader.string(text), "hi")
+            XCTAssertEqual(reader.slice(text).baseAddress, buffer.baseAddress! + 1)
+            XCTAssertEqual(try reader.next(), .bytes(4 ..< 6))
+        }
+    }
+
+    func testSkipItem() throws {
+        // {"a": [1, {_ "b": h'01'}], "c": (_ "x" "y")}, 7
+        let bytes: [UInt8] = [0xa2,
+                              0x61, 0x61, 0x82, 0x01, 0xbf, 0x61, 0x62, 0x41, 0x01, 0xff,
+                              0x61, 0x63, 0x7f, 0x61, 0x78, 0x61, 0x79, 0xff,
+                              0x07]
+        try bytes.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            try reader.skipItem()
+            XCTAssertEqual(try reader.next(), .unsigned(7))
+            XCTAssertTrue(reader.isAtEnd)
+        }
+    }
+
+    func testMalformedInput() throws {
+        XCTAssertThrowsError(try tokens([0x19, 0x01])) { error in
+            XCTAssertEqual(error as? CBORError, .unexpectedEnd(offset: 0))
+        }
+        XCTAssertThrowsError(try tokens([0x1c])) { error in
+            XCTAssertEqual(error as? CBORError, .malformed(offset: 0))
+        }
+        XCTAssertThrowsError(try tokens([0x63, 0x61])) { error in
+            XCTAssertEqual(error as? CBORError, .unexpectedEnd(offset: 0))
+        }
+        let truncated: [UInt8] = [0x01, 0x82, 0x01]
+        try truncated.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            _ = try reader.next()
+            XCTAssertThrowsError(try reader.skipItem())
+            XCTAssertEqual(reader.offset, 1)
+        }
+        let mixedChunks: [UInt8] = [0x7f, 0x41, 0x00, 0xff]
+        try mixedChunks.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            XCTAssertThrowsError(try reader.skipItem()) { error in
+                XCTAssertEqual(error as? CBORError, .malformed(offset: 1))
+            }
+        }
+    }
+
+    func testReadsDiffusionJSON() throws {
+        let json = try PTDiffusionJSON(jsonString: #"{"id": 42, "name": "widget", "tags": ["a", "b"]}"#)
+        let id: UInt64? = try json.withCBORReader { reader in
+            guard case .map(let count?) = try reader.next() else {
+                return nil
+            }
+            for _ in 0 ..< count {
+                if case .text(let key) = try reader.next(), reader.text(key, equals: "id"),
+                   case .unsigned(let value) = try reader.next() {
+                    return value
+                }
+                try reader.skipItem()
+            }
+            return nil
+        }
+        XCTAssertEqual(id, 42)
+    }
+
+    // Compares reading two fields with the reader against a full decode. The
+    // payload is transcoded from JSON text so that its key order is fixed and
+    // both fields follow the large array, which the reader must skip.
+
+    static let quotes: PTDiffusionJSON = {
+        let quotes = (0 ..< 2_000).map { index in
+            #"{"symbol":"SYM\#(index)","bid":\#(Double(index) + 0.25),"ask":\#(Double(index) + 0.5),"venue":"XLON","flags":["open","regular"]}"#
+        }
+        let text = #"{"sequence":1,"quotes":["# + quotes.joined(separator: ",") + #"],"status":"ok","updated":1700000000}"#
+        return try! PTDiffusionJSON(transcodingJSONString: text)
+    }()
+
+    func testPerformanceOfFullDecode() throws {
+        let json = CBORReaderTests.quotes
+        measure {
+            let object = try! json.object() as! [String: Any]
+            XCTAssertEqual(object["status"] as? String, "ok")
+            XCTAssertEqual(object["updated"] as? Int, 1_700_000_000)
+        }
+    }
+
+    func testPerformanceOfReader() throws {
+        let json = CBORReaderTests.quotes
+        measure {
+            let fields: (status: Bool, updated: UInt64?) = try! json.withCBORReader { reader in
+                var status = false
+                var updated: UInt64?
+                guard case .map(let count?) = try reader.next() else {
+                    return (status, updated)
+                }
+                for _ in 0 ..< count {
+                    guard case .text(let key) = try reader.next() else {
+                        break
+                    }
+                    if reader.text(key, equals: "status"), case .text(let value) = try reader.next() {
+                        status = reader.text(value, equals: "ok")
+                    } else if reader.text(key, equals: "updated"), case .unsigned(let value) = try reader.next() {
+                        updated = value
+                    } else {
+                        try reader.skipItem()
+                    }
+                    if status && updated != nil {
+                        break
+                    }
+                }
+                return (status, updated)
+            }
+            XCTAssertTrue(fields.status)
+            XCTAssertEqual(fields.updated, 1_700_000_000)
+        }
+    }
+}
@@ -0,0 +1,62 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class CBORWriterTests: XCTestCase {
+    private func encoded(_ body: (inout CBORWriter) -> Void, count: Int) -> [UInt8] {
+        return [UInt8](CBORWriter.data(count: count, body))
+    }
+
+    func testHeadsUseTheShortestForm() {
+        for argument: UInt64 in [0, 23, 24, 255, 256, 65535, 65536, 0xffff_ffff, 0x1_0000_0000] {
+            let bytes = encoded({ $0.writeUnsigned(argument) }, count: CBORWriter.costOfHead(argument))
+            XCTAssertEqual(bytes.count, CBORWriter.costOfHead(argument))
+        }
+        XCTAssertEqual(encoded({ $0.writeUnsigned(1000) }, count: 3), [0x19, 0x03, 0xe8])
+        XCTAssertEqual(encoded({ $0.writeInteger(-100) }, count: CBORWriter.cost(ofInteger: -100)), [0x38, 0x63])
+        XCTAssertEqual(encoded({ $0.writeText("IETF") }, count: CBORWriter.cost(ofTextWithUTF8Count: 4)),
+                       [0x64, 0x49, 0x45, 0x54, 0x46])
+        XCTAssertEqual(encoded({ $0.writeDouble(1.1) }, count: CBORWriter.costOfDouble),
+                       [0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a])
+    }
+
+    func testObjectEncodingRoundTripsThroughDiffusionJSON() throws {
+        let object: [String: Any] = ["name": "widget",
+                                     "count": 3,
+                                     "negative": -70_000,
+                                     "price": 9.75,
+                                     "enabled": true,
+                                     "missing": NSNull(),
+                                     "blob": Data([1, 2, 3]),
+                                     "tags": ["a", "β", "𝄞"]]
+        let size = try CBORObjectEncoder.encodedSize(of: object)
+        let json = try PTDiffusionJSON(exactlySizedObject: object)
+        XCTAssertEqual(json.data.count, size)
+        let decoded = try json.object() as! NSDictionary
+        XCTAssertEqual(decoded, object as NSDictionary)
+    }
+
+    func testUnsupportedObject() {
+        XCTAssertThrowsError(try CBORObjectEncoder.data(for: ["date": Date()]))
+    }
+
+    // Compares the growing encoder in the framework with the exact size encoder.
+
+    static let document: [String: Any] = [
+        "orders": (0 ..< 5_000).map { index -> [String: Any] in
+            return ["id": index, "side": index % 2 == 0 ? "buy" : "sell", "price": Double(index) / 8, "venue": "XLON"]
+        }
+    ]
+
+    func testPerformanceOfInitWithObject() {
+        measure {
+            _ = try! PTDiffusionJSON(object: CBORWriterTests.document)
+        }
+    }
+
+    func testPerformanceOfExactlySizedObject() {
+        measure {
+            _ = try! PTDiffusionJSON(exactlySizedObject: CBORWriterTests.document)
+        }
+    }
+}
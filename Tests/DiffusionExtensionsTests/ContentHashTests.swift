@@ -0,0 +1,71 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class ContentHashTests: XCTestCase {
+    private func hash(_ bytes: [UInt8]) -> UInt64 {
+        return bytes.withUnsafeBytes { ContentHash.hash($0) }
+    }
+
+    func testKnownValues() {
+        XCTAssertEqual(hash([]), 0xEF46DB3751D8E999)
+        XCTAssertEqual(hash(Array("a".utf8)), 0xD24EC4F1A98C6E5B)
+        XCTAssertEqual(hash(Array("abc".utf8)), 0x44BC2CF5AD770999)
+        // Inputs long enough for the stripe loop and lane merge.
+        func counting(_ count: Int) -> [UInt8] {
+            return (0 ..< count).map { UInt8(truncatingIfNeeded: $0) }
+        }
+        XCTAssertEqual(hash(counting(32)), 0xCBF59C5116FF32B4)
+        XCTAssertEqual(hash(counting(64)), 0xF7C67301DB6713F0)
+        XCTAssertEqual(hash(counting(77)), 0x93F85C1B6280EAD3)
+        XCTAssertEqual(hash(counting(100)), 0x6AC1E58032166597)
+    }
+
+    func testEveryByteAffectsTheHash() {
+        // Covers the vector loop and each tail case.
+        let bytes = (0 ..< 77).map { UInt8(truncatingIfNeeded: $0 &* 31) }
+        let original = hash(bytes)
+        for index in bytes.indices {
+            var changed = bytes
+            changed[index] ^= 1
+            XCTAssertNotEqual(hash(changed), original, "\(index)")
+        }
+        XCTAssertNotEqual(hash(Array(bytes.dropLast())), original)
+    }
+
+    func testContentHashAndEquality() throws {
+        let json = try PTDiffusionJSON(jsonString: #"{"bid":1.5,"ask":2}"#)
+        let same = PTDiffusionJSON(data: json.data)
+        let other = try PTDiffusionJSON(jsonString: #"{"bid":1.5,"ask":3}"#)
+        XCTAssertNil(json.cachedContentHash)
+        XCTAssertEqual(json.contentHash, same.contentHash)
+        XCTAssertEqual(json.cachedContentHash, json.contentHash)
+        XCTAssertNotEqual(json.contentHash, other.contentHash)
+        XCTAssertTrue(json.hasSameContent(as: same))
+        XCTAssertFalse(json.hasSameContent(as: other))
+        XCTAssertFalse(json.hasSameContent(as: PTDiffusionBinary(data: Data([1]))))
+    }
+
+    // Compares hashing with a byte comparison of the same data.
+
+    static let values = (0 ..< 100).map { _ in
+        PTDiffusionBinary(data: Data((0 ..< 100_000).map { UInt8(truncatingIfNeeded: $0) }))
+    }
+
+    func testPerformanceOfHash() {
+        measure {
+            for value in ContentHashTests.values {
+                _ = value.data.withUnsafeBytes { ContentHash.hash($0) }
+            }
+        }
+    }
+
+    func testPerformanceOfIsEqualToBinary() {
+        let first = ContentHashTests.values[0]
+        measure {
+            for value in ContentHashTests.values {
+                _ = value.isEqual(to: first)
+            }
+        }
+    }
+}
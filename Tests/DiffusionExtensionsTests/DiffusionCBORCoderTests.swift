@@ -0,0 +1,228 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class DiffusionCBORCoderTests: XCTestCase {
+    struct Quote: Codable, Equatable {
+        enum Side: String, Codable {
+            case buy, sell
+        }
+
+        var symbol: String
+        var side: Side
+        var price: Double
+        var size: Int
+        var venue: String?
+        var flags: [String]
+        var checksum: UInt8
+        var raw: Data
+    }
+
+    class Base: Codable {
+        var id = 1
+    }
+
+    final class Derived: Base {
+        var name = "derived"
+
+        private enum CodingKeys: String, CodingKey {
+            case name
+        }
+
+        override init() {
+            super.init()
+        }
+
+        required init(from decoder: Decoder) throws {
+            let container = try decoder.container(keyedBy: CodingKeys.self)
+            name = try container.decode(String.self, forKey: .name)
+            try super.init(from: container.superDecoder())
+        }
+
+        override func encode(to encoder: Encoder) throws {
+            var container = encoder.container(keyedBy: CodingKeys.self)
+            try container.encode(name, forKey: .name)
+            try super.encode(to: container.superEncoder())
+        }
+    }
+
+    static let quote = Quote(symbol: "VOD.L", side: .sell, price: 72.5, size: -300, venue: nil,
+                             flags: ["open", "auction"], checksum: 255, raw: Data([0, 1, 2]))
+
+    func testRoundTrip() throws {
+        let json = try PTDiffusionJSON(encoding: DiffusionCBORCoderTests.quote)
+        XCTAssertEqual(try json.decode(Quote.self), DiffusionCBORCoderTests.quote)
+        XCTAssertEqual(try json.decode(Quote.self, decoder: DiffusionCBORDecoder()), DiffusionCBORCoderTests.quote)
+    }
+
+    func testEncodingIsReadableByTheFramework() throws {
+        var quote = DiffusionCBORCoderTests.quote
+        quote.venue = "XLON"
+        let json = try DiffusionCBOREncoder().encodeJSON(quote)
+        let object = try json.object() as! [String: Any]
+        XCTAssertEqual(object["symbol"] as? String, "VOD.L")
+        XCTAssertEqual(object["side"] as? String, "sell")
+        XCTAssertEqual(object["price"] as? Double, 72.5)
+        XCTAssertEqual(object["size"] as? Int, -300)
+        XCTAssertEqual(object["venue"] as? String, "XLON")
+        XCTAssertEqual(object["flags"] as? [String], ["open", "auction"])
+    }
+
+    func testDecodingFrameworkEncodedValues() throws {
+        let json = try PTDiffusionJSON(jsonString: #"{"symbol":"BT.A","side":"buy","price":120,"size":5.0,"flags":[],"checksum":7,"raw":"","extra":{"ignored":[1,2]}}"#)
+        let decoded = try DiffusionCBORDecoder().decode([String: AnyDecodable].self, from: json)
+        XCTAssertEqual(decoded.count, 8)
+        XCTAssertThrowsError(try json.decode(Quote.self)) { error in
+            // "raw" is a text string in the JSON text, not a byte string.
+            guard case DecodingError.typeMismatch(_, let context)? = error as? DecodingError else {
+                return XCTFail("\(error)")
+            }
+            XCTAssertEqual(context.codingPath.map { $0.stringValue }, ["raw"])
+        }
+    }
+
+    func testClassHierarchyUsesSuperEncoder() throws {
+        let data = try DiffusionCBOREncoder().encode(Derived())
+        let decoded = try DiffusionCBORDecoder().decode(Derived.self, from: data)
+        XCTAssertEqual(decoded.id, 1)
+        XCTAssertEqual(decoded.name, "derived")
+    }
+
+    func testDictionaryKeysAreNotInterned() throws {
+        var quotes = [String: Quote]()
+        for index in 0 ..< 2_000 {
+            var quote = DiffusionCBORCoderTests.quote
+            quote.symbol = "SYM\(index)"
+            quotes[quote.symbol] = quote
+        }
+        let decoder = DiffusionCBORDecoder()
+        XCTAssertEqual(try decoder.decode([String: Quote].self, from: DiffusionCBOREncoder().encode(quotes)), quotes)
+        // Only the field names of Quote are interned, not the symbols.
+        XCTAssertEqual(decoder.keys.count, 7)
+    }
+
+    struct Overwriting: Encodable {
+        enum CodingKeys: String, CodingKey {
+            case a, b
+        }
+
+        func encode(to encoder: Encoder) throws {
+            var container = encoder.container(keyedBy: CodingKeys.self)
+            try container.encode(1, forKey: .a)
+            try container.encode(2, forKey: .b)
+            try container.encode("x", forKey: .a)
+        }
+    }
+
+    func testEncodingAKeyAgainReplacesItsValue() throws {
+        let data = try DiffusionCBOREncoder().encode(Overwriting())
+        // {"a": "x", "b": 2}
+        XCTAssertEqual(data, Data([0xa2, 0x61, 0x61, 0x61, 0x78, 0x61, 0x62, 0x02]))
+        let object = try PTDiffusionJSON(data: data).object() as! [String: Any]
+        XCTAssertEqual(object as NSDictionary, try JSONSerialization.jsonObject(with: JSONEncoder().encode(Overwriting())) as! NSDictionary)
+    }
+
+    struct Link: Codable, Equatable {
+        var url: URL
+        var price: Decimal
+        var quantity: Decimal
+    }
+
+    func testURLAndDecimal() throws {
+        let link = Link(url: URL(string: "https://example.com/a?b=c")!,
+                        price: Decimal(string: "12.25")!,
+                        quantity: 300)
+        let json = try PTDiffusionJSON(encoding: link)
+        XCTAssertEqual(try json.decode(Link.self), link)
+
+        // Other clients see the same shape as for JSONEncoder output.
+        let object = try json.object() as! [String: Any]
+        XCTAssertEqual(object["url"] as? String, "https://example.com/a?b=c")
+        XCTAssertEqual(object["price"] as? Double, 12.25)
+        XCTAssertEqual(object["quantity"] as? Int, 300)
+        let expected = try PTDiffusionJSON(jsonData: JSONEncoder().encode(link))
+        XCTAssertEqual(try expected.object() as? NSDictionary, object as NSDictionary)
+        XCTAssertEqual(try expected.decode(Link.self), link)
+    }
+
+    func testNonFiniteValuesAreRejected() {
+        for value in [Double.nan, .infinity, -.infinity] {
+            XCTAssertThrowsError(try DiffusionCBOREncoder().encode(["value": value])) { error in
+                guard case EncodingError.invalidValue(_, let context)? = error as? EncodingError else {
+                    return XCTFail("\(error)")
+                }
+                XCTAssertEqual(context.codingPath.map { $0.stringValue }, ["value"])
+            }
+        }
+        XCTAssertThrowsError(try DiffusionCBOREncoder().encode([Float.nan]))
+        XCTAssertThrowsError(try DiffusionCBOREncoder().encode(Decimal.nan))
+    }
+
+    func testErrors() throws {
+        let encoder = DiffusionCBOREncoder()
+        XCTAssertThrowsError(try DiffusionCBORDecoder().decode(UInt8.self, from: encoder.encode(256))) { error in
+            guard case DecodingError.dataCorrupted? = error as? DecodingError else {
+                return XCTFail("\(error)")
+            }
+        }
+        XCTAssertThrowsError(try DiffusionCBORDecoder().decode([Int].self, from: encoder.encode(["a": 1])))
+        XCTAssertThrowsError(try DiffusionCBORDecoder().decode(Int.self, from: Data([0x19, 0x01])))
+        XCTAssertThrowsError(try DiffusionCBORDecoder().decode(Int.self, from: Data([0x01, 0x02])))
+        XCTAssertThrowsError(try DiffusionCBORDecoder().decode(Quote.self, from: encoder.encode(["symbol": "X"]))) { error in
+            guard case DecodingError.keyNotFound? = error as? DecodingError else {
+                return XCTFail("\(error)")
+            }
+        }
+    }
+
+    // Compares the Codable path through JSON text and Foundation objects
+    // with direct CBOR encoding and decoding.
+
+    struct Tick: Codable {
+        var symbol: String
+        var bid: Double
+        var ask: Double
+        var size: Int
+        var venue: String
+        var flags: [String]
+    }
+
+    static let ticks = (0 ..< 5_000).map { index in
+        Tick(symbol: "SYM\(index)", bid: Double(index) / 4, ask: Double(index) / 4 + 0.5,
+             size: index, venue: "XLON", flags: ["open"])
+    }
+
+    func testPerformanceOfFoundationEncoding() {
+        measure {
+            _ = try! PTDiffusionJSON(jsonData: JSONEncoder().encode(DiffusionCBORCoderTests.ticks))
+        }
+    }
+
+    func testPerformanceOfCBOREncoding() {
+        measure {
+            _ = try! PTDiffusionJSON(encoding: DiffusionCBORCoderTests.ticks)
+        }
+    }
+
+    func testPerformanceOfFoundationDecoding() {
+        let json = try! PTDiffusionJSON(encoding: DiffusionCBORCoderTests.ticks)
+        measure {
+            let data = try! JSONSerialization.data(withJSONObject: json.object())
+            _ = try! JSONDecoder().decode([Tick].self, from: data)
+        }
+    }
+
+    func testPerformanceOfCBORDecoding() {
+        let json = try! PTDiffusionJSON(encoding: DiffusionCBORCoderTests.ticks)
+        let decoder = DiffusionCBORDecoder()
+        measure {
+            _ = try! decoder.decode([Tick].self, from: json)
+        }
+    }
+}
+
+/// Decodes and discards any value.
+private struct AnyDecodable: Decodable {
+    init(from decoder: Decoder) throws {
+    }
+}
@@ -0,0 +1,130 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class JSONTranscoderTests: XCTestCase {
+    private func cbor(_ json: String) throws -> [UInt8] {
+        return [UInt8](try JSONTranscoder.cbor(fromJSON: Data(json.utf8)))
+    }
+
+    private func json(_ cbor: [UInt8]) throws -> String {
+        return String(decoding: try JSONTranscoder.json(fromCBOR: Data(cbor)), as: UTF8.self)
+    }
+
+    func testScalars() throws {
+        XCTAssertEqual(try cbor("0"), [0x00])
+        XCTAssertEqual(try cbor(" 1000 "), [0x19, 0x03, 0xe8])
+        XCTAssertEqual(try cbor("-100"), [0x38, 0x63])
+        XCTAssertEqual(try cbor("-0"), [0x00])
+        XCTAssertEqual(try cbor("18446744073709551615"), [0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff])
+        XCTAssertEqual(try cbor("1.1"), [0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a])
+        XCTAssertEqual(try cbor("1e2"), [0xfb, 0x40, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00])
+        XCTAssertEqual(try cbor("[true,false,null]"), [0x83, 0xf5, 0xf4, 0xf6])
+    }
+
+    func testStrings() throws {
+        XCTAssertEqual(try cbor(#""a\"b""#), [0x63, 0x61, 0x22, 0x62])
+        XCTAssertEqual(try cbor(#""\u00e9\ud834\udd1e""#), [0x66, 0xc3, 0xa9, 0xf0, 0x9d, 0x84, 0x9e])
+        XCTAssertEqual(try cbor(#""ünïcödé""#), [0x6b] + Array("ünïcödé".utf8))
+        let long = String(repeating: "abcdefgh", count: 8) + "\\n"
+        XCTAssertEqual(try cbor("\"\(long)\""), [0x78, 65] + Array(String(repeating: "abcdefgh", count: 8).utf8) + [0x0a])
+    }
+
+    func testContainers() throws {
+        XCTAssertEqual(try cbor(#"{"a": [1, {}], "b": []}"#),
+                       [0xa2, 0x61, 0x61, 0x82, 0x01, 0xa0, 0x61, 0x62, 0x80])
+    }
+
+    func testInvalidJSON() {
+        for (text, offset) in [("", 0), ("[1,]", 3), ("{\"a\" 1}", 5), ("01", 1), ("\"\u{01}\"", 1),
+                               ("[1 2]", 3), ("\"\\ud800\"", 1), ("tru", 0), ("1.", 2), ("[", 1)] {
+            XCTAssertThrowsError(try cbor(text), text) { error in
+                XCTAssertEqual(error as? JSONTranscodingError, .invalidJSON(offset: offset), text)
+            }
+        }
+    }
+
+    func testCBORToJSON() throws {
+        XCTAssertEqual(try json([0xa2, 0x61, 0x61, 0x82, 0x01, 0x38, 0x63, 0x61, 0x62, 0xf6]), #"{"a":[1,-100],"b":null}"#)
+        XCTAssertEqual(try json([0x64, 0x22, 0x5c, 0x0a, 0x01]), #""\"\\\n\u0001""#)
+        XCTAssertEqual(try json([0x9f, 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a, 0xf5, 0xff]), "[1.1,true]")
+        XCTAssertThrowsError(try json([0xa1, 0x01, 0x02]))
+        XCTAssertThrowsError(try json([0x41, 0x00]))
+    }
+
+    func testAgreesWithDiffusionJSON() throws {
+        let text = #"{"name":"widget","price":9.75,"sizes":[1,2,3],"meta":{"live":true,"note":"tab\there"}}"#
+        let transcoded = try PTDiffusionJSON(transcodingJSONString: text)
+        let expected = try PTDiffusionJSON(jsonString: text)
+        XCTAssertEqual(try transcoded.object() as? NSDictionary, try expected.object() as? NSDictionary)
+        let roundTripped = try JSONSerialization.jsonObject(with: try transcoded.transcodedJSONData())
+        XCTAssertEqual(roundTripped as? NSDictionary, try expected.object() as? NSDictionary)
+    }
+
+    func testDuplicateKeys() throws {
+        // NSJSONSerialization keeps the last value, which a CBOR map cannot
+        // represent alongside the first, so the transcoder rejects the text.
+        for (text, offset) in [(#"{"a":1,"b":2,"a":3}"#, 13), (#"{"a":1,"\u0061":2}"#, 7),
+                               (#"[{"a":{"b":1,"b":2}}]"#, 13), (#"{"":1,"":2}"#, 6)] {
+            XCTAssertNoThrow(try PTDiffusionJSON(jsonData: Data(text.utf8)), text)
+            XCTAssertThrowsError(try PTDiffusionJSON(transcodingJSONString: text), text) { error in
+                XCTAssertEqual(error as? JSONTranscodingError, .duplicateKey(offset: offset), text)
+            }
+        }
+        // Keys that differ only in nested objects are not duplicates.
+        let text = #"{"a":{"x":1},"b":{"x":2},"\u00e9":3,"é ":4}"#
+        XCTAssertEqual(try PTDiffusionJSON(transcodingJSONString: text).object() as? NSDictionary,
+                       try PTDiffusionJSON(jsonData: Data(text.utf8)).object() as? NSDictionary)
+    }
+
+    // Compares throughput over a small corpus of representative documents.
+
+    static let corpus: [Data] = {
+        let feed = (0 ..< 2_000).map { index in
+            #"{"symbol":"SYM\#(index)","bid":\#(Double(index) + 0.25),"ask":\#(Double(index) + 0.5),"size":\#(index * 100)}"#
+        }
+        let posts = (0 ..< 500).map { index in
+            #"{"id":\#(index),"user":{"name":"user \#(index)","verified":\#(index % 3 == 0)},"text":"Caf\u00e9 d\u00e9j\u00e0 vu \"quoted\" #\#(index)","tags":["a","b","c"],"reply":null}"#
+        }
+        let config = #"{"servers":[{"host":"a.example.com","port":443,"tls":true,"weights":[0.5,0.25,0.25]}],"retry":{"attempts":5,"backoff":1.5},"name":"\#(String(repeating: "long value ", count: 200))"}"#
+        return ["[" + feed.joined(separator: ",") + "]", "[" + posts.joined(separator: ",") + "]", config].map { Data($0.utf8) }
+    }()
+
+    /// Measures the body over every document in the corpus, attaching the
+    /// corpus size so that throughput can be derived from the measured time.
+    private func measureCorpus(_ body: @escaping (Data) -> Void) {
+        let bytes = JSONTranscoderTests.corpus.reduce(0) { $0 + $1.count }
+        add(XCTAttachment(string: "JSON corpus: \(bytes) bytes"))
+        measure {
+            for document in JSONTranscoderTests.corpus {
+                body(document)
+            }
+        }
+    }
+
+    func testPerformanceOfInitWithJSONData() {
+        measureCorpus { _ = try! PTDiffusionJSON(jsonData: $0) }
+    }
+
+    func testPerformanceOfTranscodingJSONData() {
+        measureCorpus { _ = try! PTDiffusionJSON(transcodingJSONData: $0) }
+    }
+
+    func testPerformanceOfJSONDataWithError() {
+        let values = JSONTranscoderTests.corpus.map { try! PTDiffusionJSON(jsonData: $0) }
+        measure {
+            for value in values {
+                _ = try! value.jsonData()
+            }
+        }
+    }
+
+    func testPerformanceOfTranscodedJSONData() {
+        let values = JSONTranscoderTests.corpus.map { try! PTDiffusionJSON(jsonData: $0) }
+        measure {
+            for value in values {
+                _ = try! value.transcodedJSONData()
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class LazyJSONViewTests: XCTestCase {
+    static let text = #"{"name":"book","prices":[{"bid":1.5,"ask":2},{"bid":-3,"ask":4.25}],"open":true,"close":null,"a/b":{"m~n":"escaped"},"":"empty"}"#
+
+    private func makeView() throws -> LazyJSONView {
+        return try PTDiffusionJSON(transcodingJSONString: LazyJSONViewTests.text).lazyView()
+    }
+
+    func testTypedAccess() throws {
+        let view = try makeView()
+        XCTAssertEqual(try view.string(at: "/name"), "book")
+        XCTAssertEqual(try view.double(at: "/prices/0/bid"), 1.5)
+        XCTAssertEqual(try view.integer(at: "/prices/1/bid"), -3)
+        XCTAssertEqual(try view.double(at: "/prices/1/bid"), -3)
+        XCTAssertEqual(try view.integer(at: "/prices/0/ask"), 2)
+        XCTAssertEqual(try view.bool(at: "/open"), true)
+        XCTAssertTrue(try view.isNull(at: "/close"))
+        XCTAssertEqual(try view.count(at: "/prices"), 2)
+        XCTAssertEqual(try view.count(at: ""), 6)
+    }
+
+    func testMissingAndMismatchedValues() throws {
+        let view = try makeView()
+        XCTAssertNil(try view.offset(at: "/missing"))
+        XCTAssertNil(try view.offset(at: "/prices/2"))
+        XCTAssertNil(try view.offset(at: "/prices/-"))
+        XCTAssertNil(try view.offset(at: "/prices/01"))
+        XCTAssertNil(try view.offset(at: "/name/0"))
+        XCTAssertNil(try view.string(at: "/open"))
+        XCTAssertNil(try view.integer(at: "/prices/0/bid"))
+        XCTAssertFalse(try view.isNull(at: "/name"))
+        XCTAssertNil(try view.count(at: "/name"))
+    }
+
+    func testPointerSyntax() throws {
+        let view = try makeView()
+        XCTAssertEqual(try view.offset(at: ""), 0)
+        XCTAssertEqual(try view.string(at: "/a~1b/m~0n"), "escaped")
+        XCTAssertEqual(try view.string(at: "/"), "empty")
+        for pointer in ["name", "/a~2b", "/a~"] {
+            XCTAssertThrowsError(try view.offset(at: pointer), pointer) { error in
+                XCTAssertEqual(error as? JSONPointerError, .invalidPointer(pointer))
+            }
+        }
+    }
+
+    func testKeysOfOtherTypes() throws {
+        // {[1, 2]: "x", (_ "a"): 1, (_ "b", "c"): 2, "k": 5}
+        let json = PTDiffusionJSON(data: Data([0xa4, 0x82, 0x01, 0x02, 0x61, 0x78,
+                                               0x7f, 0x61, 0x61, 0xff, 0x01,
+                                               0x7f, 0x61, 0x62, 0x61, 0x63, 0xff, 0x02,
+                                               0x61, 0x6b, 0x05]))
+        let keys = CBORStringTable()
+        let view = json.lazyView(keys: keys)
+        XCTAssertEqual(try view.integer(at: "/k"), 5)
+        XCTAssertEqual(try view.integer(at: "/a"), 1)
+        XCTAssertEqual(try view.integer(at: "/bc"), 2)
+        XCTAssertNil(try view.offset(at: "/b"))
+        XCTAssertEqual(try view.count(at: ""), 3)
+        XCTAssertEqual(keys.count, 1)
+    }
+
+    func testValuesAreNotInterned() throws {
+        let keys = CBORStringTable()
+        let view = try PTDiffusionJSON(transcodingJSONString: LazyJSONViewTests.text).lazyView(keys: keys)
+        let internedKeys = try view.count(at: "") ?? 0
+        XCTAssertEqual(try view.string(at: "/name"), "book")
+        XCTAssertEqual(keys.count, internedKeys)
+    }
+
+    func testSubvalues() throws {
+        struct Price: Decodable, Equatable {
+            var bid: Double
+            var ask: Double
+        }
+
+        let view = try makeView()
+        XCTAssertEqual(try view.decode(Price.self, at: "/prices/1"), Price(bid: -3, ask: 4.25))
+        XCTAssertNil(try view.decode(Price.self, at: "/prices/2"))
+        let json = try XCTUnwrap(view.json(at: "/prices/0"))
+        XCTAssertEqual(try json.object() as? NSDictionary, ["bid": 1.5, "ask": 2])
+    }
+
+    // Compares reading a few values from a large document through a lazy
+    // view with converting the whole document to Foundation objects.
+
+    static let document: PTDiffusionJSON = {
+        let levels = (0 ..< 1_000).map { index in
+            #"{"bid":\#(Double(index) + 0.25),"ask":\#(Double(index) + 0.5),"size":\#(index * 100),"venue":"XLON"}"#
+        }
+        return try! PTDiffusionJSON(transcodingJSONString: #"{"symbol":"VOD.L","prices":["# + levels.joined(separator: ",") + "]}")
+    }()
+
+    func testPerformanceOfObject() {
+        let json = LazyJSONViewTests.document
+        measure {
+            for _ in 0 ..< 10 {
+                let object = try! json.object() as! [String: Any]
+                let prices = object["prices"] as! [[String: Any]]
+                _ = prices[500]["bid"] as! Double
+            }
+        }
+    }
+
+    func testPerformanceOfLazyView() {
+        let json = LazyJSONViewTests.document
+        let keys = CBORStringTable()
+        measure {
+            for _ in 0 ..< 10 {
+                _ = try! json.lazyView(keys: keys).double(at: "/prices/500/bid")!
+            }
+        }
+    }
+}
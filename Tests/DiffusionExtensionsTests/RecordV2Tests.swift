@@ -0,0 +1,148 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class RecordV2Tests: XCTestCase {
+    static let schema = PTDiffusionRecordV2SchemaBuilder()
+        .addRecord(withName: "header")
+        .addString(withName: "symbol")
+        .addInteger(withName: "sequence")
+        .addRecord(withName: "level", min: 0, max: -1)
+        .addDecimal(withName: "bid", scale: 2)
+        .addDecimal(withName: "ask", scale: 2)
+        .addInteger(withName: "size", min: 0, max: -1)
+        .build()
+
+    func testPlan() throws {
+        let plan = RecordV2Tests.schema.compiledPlan()
+        XCTAssertEqual(plan.slot(record: "header", field: "sequence"), RecordV2Slot(record: 0, field: 1, scale: 0))
+        XCTAssertEqual(plan.slot(record: "level", recordIndex: 3, field: "ask"), RecordV2Slot(record: 4, field: 1, scale: 2))
+        XCTAssertEqual(plan.slot(record: "level", field: "size", fieldIndex: 5), RecordV2Slot(record: 1, field: 7, scale: 0))
+        XCTAssertNil(plan.slot(record: "header", recordIndex: 1, field: "symbol"))
+        XCTAssertNil(plan.slot(record: "header", field: "symbol", fieldIndex: 1))
+        XCTAssertNil(plan.slot(record: "header", field: "bid"))
+        XCTAssertNil(plan.slot(record: "trailer", field: "symbol"))
+        let ask = plan.slot(record: "level", field: "ask")!
+        XCTAssertEqual(ask.advanced(byRecords: 3), plan.slot(record: "level", recordIndex: 3, field: "ask"))
+        let size = plan.slot(record: "level", field: "size")!
+        XCTAssertEqual(size.advanced(byRecords: 1, fields: 2),
+                       plan.slot(record: "level", recordIndex: 1, field: "size", fieldIndex: 2))
+    }
+
+    func testFieldTableAgreesWithRecordsWithError() throws {
+        let values: [[[String]]] = [[], [["a"]], [["", "b"], ["c", ""]], [["x", "y", "z"]],
+                                    [[String(repeating: "long field text ", count: 4), "1"]]]
+        for records in values {
+            let builder = PTDiffusionRecordV2Builder()
+            for fields in records {
+                builder.addRecord(withFields: fields)
+            }
+            let value = builder.build()
+            let expected = try value.records()
+            let table = RecordV2FieldTable(value)
+            XCTAssertEqual(table.recordCount, expected.count, "\(records)")
+            for (recordIndex, fields) in expected.enumerated() where recordIndex < table.recordCount {
+                XCTAssertEqual(table.fieldCount(inRecord: recordIndex), fields.count, "\(records)")
+                for (fieldIndex, field) in fields.enumerated() {
+                    let slot = RecordV2Slot(record: recordIndex, field: fieldIndex, scale: 0)
+                    XCTAssertEqual(table.string(at: slot), field, "\(records)")
+                }
+            }
+        }
+    }
+
+    func testTypedFields() throws {
+        let plan = RecordV2Tests.schema.compiledPlan()
+        let value = PTDiffusionRecordV2Builder()
+            .addRecord(withFields: ["VOD.L", "-42"])
+            .addRecord(withFields: ["72.5", "72.75", "100", "200"])
+            .addRecord(withFields: ["-0.05", "1.234", "x"])
+            .build()
+        let table = RecordV2FieldTable(value)
+        XCTAssertEqual(table.string(at: plan.slot(record: "header", field: "symbol")!), "VOD.L")
+        XCTAssertEqual(table.integer(at: plan.slot(record: "header", field: "sequence")!), -42)
+        XCTAssertEqual(table.scaledDecimal(at: plan.slot(record: "level", field: "bid")!), 7250)
+        XCTAssertEqual(table.decimal(at: plan.slot(record: "level", field: "ask")!), Decimal(string: "72.75"))
+        XCTAssertEqual(table.integer(at: plan.slot(record: "level", field: "size", fieldIndex: 1)!), 200)
+        XCTAssertEqual(table.scaledDecimal(at: plan.slot(record: "level", recordIndex: 1, field: "bid")!), -5)
+        // Too many fractional digits for the scale, and not a number.
+        XCTAssertNil(table.scaledDecimal(at: plan.slot(record: "level", recordIndex: 1, field: "ask")!))
+        XCTAssertNil(table.integer(at: plan.slot(record: "level", recordIndex: 1, field: "size")!))
+        XCTAssertNil(table.integer(at: plan.slot(record: "level", recordIndex: 2, field: "size")!))
+    }
+
+    func testParse() {
+        func parse(_ text: String, scale: Int) -> Int64? {
+            return Array(text.utf8).withUnsafeBytes { RecordV2FieldTable.parse($0, scale: scale) }
+        }
+        XCTAssertEqual(parse("0", scale: 0), 0)
+        XCTAssertEqual(parse("9223372036854775807", scale: 0), Int64.max)
+        XCTAssertEqual(parse("-9223372036854775808", scale: 0), Int64.min)
+        XCTAssertNil(parse("9223372036854775808", scale: 0))
+        XCTAssertEqual(parse("1.5", scale: 3), 1500)
+        XCTAssertNil(parse("1.5", scale: 0))
+        XCTAssertNil(parse("", scale: 0))
+        XCTAssertNil(parse("-", scale: 0))
+        XCTAssertNil(parse("1e3", scale: 0))
+    }
+
+    func testWriterMatchesBuilder() {
+        var writer = RecordV2Writer()
+        writer.append("VOD.L")
+        writer.append(-42)
+        writer.beginRecord()
+        writer.append(scaledDecimal: 7250, scale: 2)
+        writer.append(scaledDecimal: -5, scale: 3)
+        writer.append("")
+        writer.append(Int64.min)
+        let expected = PTDiffusionRecordV2Builder()
+            .addRecord(withFields: ["VOD.L", "-42"])
+            .addRecord(withFields: ["72.50", "-0.005", "", "-9223372036854775808"])
+            .build()
+        XCTAssertEqual(writer.record().data, expected.data)
+        writer.removeAll()
+        XCTAssertEqual(writer.record().data, Data())
+    }
+
+    // Compares reading every level of a price feed value through the
+    // framework's parser with reading it through a field table.
+
+    static let feed: PTDiffusionRecordV2 = {
+        var writer = RecordV2Writer()
+        writer.append("VOD.L")
+        writer.append(1)
+        for level in 0 ..< 1_000 {
+            writer.beginRecord()
+            writer.append(scaledDecimal: Int64(7_000 + level), scale: 2)
+            writer.append(scaledDecimal: Int64(7_025 + level), scale: 2)
+            writer.append(Int64(level * 100))
+        }
+        return writer.record()
+    }()
+
+    func testPerformanceOfRecordsWithError() {
+        measure {
+            var total = 0.0
+            for fields in try! RecordV2Tests.feed.records().dropFirst() {
+                total += Double(fields[0])! + Double(fields[1])!
+            }
+            XCTAssertGreaterThan(total, 0)
+        }
+    }
+
+    func testPerformanceOfFieldTable() {
+        let plan = RecordV2Tests.schema.compiledPlan()
+        let bid = plan.slot(record: "level", field: "bid")!
+        let ask = plan.slot(record: "level", field: "ask")!
+        var table = RecordV2FieldTable()
+        measure {
+            table.reload(RecordV2Tests.feed.data)
+            var total: Int64 = 0
+            for level in 0 ..< table.recordCount - 1 {
+                total += table.scaledDecimal(at: bid.advanced(byRecords: level))!
+                total += table.scaledDecimal(at: ask.advanced(byRecords: level))!
+            }
+            XCTAssertGreaterThan(total, 0)
+        }
+    }
+}
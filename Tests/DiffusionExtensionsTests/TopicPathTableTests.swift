@@ -0,0 +1,66 @@
+import XCTest
+@testable import DiffusionExtensions
+
+final class TopicPathTableTests: XCTestCase {
+    func testInterning() {
+        let table = TopicPathTable()
+        let quote = table.intern("prices/VOD.L/bid")
+        XCTAssertEqual(table.intern("prices/VOD.L/bid"), quote)
+        XCTAssertNotEqual(table.intern("prices/VOD.L/ask"), quote)
+        XCTAssertEqual(table.count, 4)
+        XCTAssertEqual(table.segmentCount, 4)
+        XCTAssertEqual(table.path(for: quote), "prices/VOD.L/bid")
+        XCTAssertEqual(table.lastSegment(of: quote), "bid")
+        XCTAssertEqual(table.parent(of: quote), table.existing("prices/VOD.L"))
+        XCTAssertEqual(table.existing("prices/VOD.L/bid"), quote)
+        XCTAssertNil(table.existing("prices/BT.A"))
+        XCTAssertEqual(table.count, 4)
+    }
+
+    func testPathsRoundTrip() {
+        let table = TopicPathTable()
+        for path in ["", "a", "/a", "a/", "a//b", "/", "bid/bid/bid", "ünï/cödé"] {
+            XCTAssertEqual(table.path(for: table.intern(path)), path, path)
+        }
+        XCTAssertEqual(table.intern(""), TopicPathTable.root)
+        XCTAssertNil(table.parent(of: TopicPathTable.root))
+        XCTAssertNil(table.lastSegment(of: TopicPathTable.root))
+    }
+
+    func testRemoveAll() {
+        let table = TopicPathTable()
+        _ = table.intern("a/b")
+        table.removeAll()
+        XCTAssertEqual(table.count, 0)
+        XCTAssertNil(table.existing("a"))
+        XCTAssertEqual(table.path(for: table.intern("c")), "c")
+    }
+
+    // Interns a large set of paths sharing prefixes and segments, as for a
+    // client subscribed to many topics.
+
+    static let paths = (0 ..< 100_000).map { index in
+        "markets/equities/venue\(index % 10)/SYM\(index / 10)/\(index % 2 == 0 ? "bid" : "ask")"
+    }
+
+    func testPerformanceOfInterning() {
+        measure {
+            let table = TopicPathTable()
+            for path in TopicPathTableTests.paths {
+                _ = table.intern(path)
+            }
+        }
+    }
+
+    func testPerformanceOfLookup() {
+        let table = TopicPathTable()
+        for path in TopicPathTableTests.paths {
+            _ = table.intern(path)
+        }
+        measure {
+            for path in TopicPathTableTests.paths {
+                _ = table.existing(path)
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+import XCTest
+import Diffusion
+@testable import DiffusionExtensions
+
+final class UTF8ValidationTests: XCTestCase {
+    private func firstInvalidOffset(_ bytes: [UInt8]) -> Int? {
+        return bytes.withUnsafeBytes { UTF8Validation.firstInvalidOffset(in: $0) }
+    }
+
+    func testValidInput() {
+        XCTAssertNil(firstInvalidOffset([]))
+        XCTAssertNil(firstInvalidOffset(Array("plain ascii that spans more than one block".utf8)))
+        XCTAssertNil(firstInvalidOffset(Array("£ € 𝄞 — αβγ and some ascii after sixteen bytes".utf8)))
+        XCTAssertNil(firstInvalidOffset([0xf4, 0x8f, 0xbf, 0xbf]))
+    }
+
+    func testInvalidInput() {
+        let prefix = Array("0123456789abcdefXYZ".utf8)
+        XCTAssertEqual(firstInvalidOffset(prefix + [0x80]), 19)
+        XCTAssertEqual(firstInvalidOffset(prefix + [0xc0, 0xaf]), 19)
+        XCTAssertEqual(firstInvalidOffset(prefix + [0xe0, 0x80, 0xaf]), 19)
+        XCTAssertEqual(firstInvalidOffset(prefix + [0xed, 0xa0, 0x80]), 19)
+        XCTAssertEqual(firstInvalidOffset(prefix + [0xf4, 0x90, 0x80, 0x80]), 19)
+        XCTAssertEqual(firstInvalidOffset(prefix + [0xe2, 0x82]), 19)
+    }
+
+    func testInterning() throws {
+        let table = CBORStringTable(capacity: 2)
+        let bytes: [UInt8] = [0x63, 0x62, 0x69, 0x64, 0x63, 0x62, 0x69, 0x64,
+                              0x63, 0x61, 0x73, 0x6b, 0x63, 0x71, 0x74, 0x79]
+        try bytes.withUnsafeBytes { buffer in
+            var reader = CBORReader(buffer)
+            var strings = [String]()
+            while !reader.isAtEnd {
+                guard case .text(let range) = try reader.next() else {
+                    return XCTFail()
+                }
+                strings.append(try reader.validatedString(range, interning: table))
+            }
+            XCTAssertEqual(strings, ["bid", "bid", "ask", "qty"])
+        }
+        XCTAssertEqual(table.count, 2)
+    }
+
+    func testValidatedStringRejectsInvalidUTF8() {
+        let bytes: [UInt8] = [0x63, 0x61, 0xff, 0x62]
+        bytes.withUnsafeBytes { buffer in
+            let reader = CBORReader(buffer)
+            XCTAssertEqual(reader.string(1 ..< 4), "a\u{fffd}b")
+            XCTAssertThrowsError(try reader.validatedString(1 ..< 4, interning: CBORStringTable())) { error in
+                XCTAssertEqual(error as? CBORError, .invalidUTF8(offset: 2))
+            }
+        }
+    }
+
+    // Measures text decoding over a key-heavy document, interning the keys
+    // and materialising the values as a decoder would, and reports the rate
+    // in MB/s of CBOR input.
+
+    func testPerformanceOfTextDecoding() throws {
+        let rows = (0 ..< 5_000).map { index in
+            return ["instrument": "INSTRUMENT-\(index)", "currency": "GBP", "venue": "XLON", "state": "open"]
+        }
+        let json = try PTDiffusionJSON(object: rows)
+        let table = CBORStringTable()
+        let decode: () -> Void = {
+            try! json.withCBORReader { reader in
+                guard case .array(let count?) = try reader.next() else {
+                    return XCTFail()
+                }
+                for _ in 0 ..< count {
+                    guard case .map(let fields?) = try reader.next() else {
+                        return XCTFail()
+                    }
+                    for _ in 0 ..< fields {
+                        guard case .text(let key) = try reader.next(), case .text(let value) = try reader.next() else {
+                            return XCTFail()
+                        }
+                        _ = try reader.validatedString(key, interning: table)
+                        _ = try reader.validatedString(value)
+                    }
+                }
+            }
+        }
+        if #available(macOS 10.15, iOS 13.0, tvOS 13.0, *) {
+            measure(metrics: [XCTClockMetric(), ThroughputMetric(bytes: json.data.count)], block: decode)
+        } else {
+            measure(decode)
+        }
+        // Only the four keys are interned.
+        XCTAssertEqual(table.count, 4)
+    }
+}
+
+/// Reports the rate at which a measured block processes a known number of
+/// bytes, using the timestamps that XCTest takes around each iteration.
+@available(macOS 10.15, iOS 13.0, tvOS 13.0, *)
+final class ThroughputMetric: NSObject, XCTMetric {
+    let bytes: Int
+
+    init(bytes: Int) {
+        self.bytes = bytes
+    }
+
+    func copy(with zone: NSZone? = nil) -> Any {
+        return ThroughputMetric(bytes: bytes)
+    }
+
+    func reportMeasurements(from startTime: XCTPerformanceMeasurementTimestamp,
+                            to endTime: XCTPerformanceMeasurementTimestamp) throws -> [XCTPerformanceMeasurement] {
+        let seconds = Double(endTime.absoluteTimeNanoSeconds - startTime.absoluteTimeNanoSeconds) / 1e9
+        return [XCTPerformanceMeasurement(identifier: "ThroughputMetric.megabytesPerSecond",
+                                          displayName: "Throughput",
+                                          doubleValue: Double(bytes) / seconds / 1e6,
+                                          unitSymbol: "MB/s")]
+    }
+}